@@ -1,4 +1,4 @@
-QT       += core gui multimedia
+QT       += core gui multimedia concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -8,6 +8,14 @@ CONFIG += c++11
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# Lowest log level compiled into LOG_* macros (0 trace, 1 debug, 2 info, 3 warn).
+# Defaults to debug in debug builds and warn in release builds (see include/logger.h).
+#DEFINES += TE_LOG_MIN_LEVEL=0
+
+# Profiling build (qmake CONFIG+=profiling): replaces global operator new/delete
+# so the profiler overlay can show heap allocations per tick.
+profiling: DEFINES += TE_COUNT_ALLOCATIONS
+
 SOURCES += \
     src/enemy.cpp \
     src/gameentity.cpp \
@@ -21,7 +29,22 @@ SOURCES += \
     src/bullet.cpp \
     src/placementvalidator.cpp \
     src/quadtree.cpp \
-    src/levelselectpage.cpp
+    src/levelselectpage.cpp \
+    src/frameprofiler.cpp \
+    src/gameview.cpp \
+    src/tracerecorder.cpp \
+    src/logger.cpp \
+    src/audiomixer.cpp \
+    src/startuptimeline.cpp \
+    src/levelpreloader.cpp \
+    src/savegame.cpp \
+    src/progressstore.cpp \
+    src/occupancygrid.cpp \
+    src/flowfield.cpp \
+    src/cutcellindex.cpp \
+    src/lanepath.cpp \
+    src/simdkernels.cpp \
+    src/targetingindex.cpp
 
 HEADERS += \
     include/config.h \
@@ -36,7 +59,27 @@ HEADERS += \
     include/bullet.h \
     include/placementvalidator.h \
     include/quadtree.h \
-    include/levelselectpage.h
+    include/levelselectpage.h \
+    include/frameprofiler.h \
+    include/gameview.h \
+    include/eventring.h \
+    include/tracerecorder.h \
+    include/logger.h \
+    include/audiomixer.h \
+    include/spscqueue.h \
+    include/startuptimeline.h \
+    include/levelpreloader.h \
+    include/savegame.h \
+    include/gamerandom.h \
+    include/progressstore.h \
+    include/occupancygrid.h \
+    include/flowfield.h \
+    include/cutcellindex.h \
+    include/lanepath.h \
+    include/simdkernels.h \
+    include/targetingindex.h \
+    include/spatialindex.h \
+    include/fastmath.h
 
 FORMS += \
     ui/mainmenupage.ui \
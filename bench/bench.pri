@@ -0,0 +1,61 @@
+# Shared setup for benchmark targets: pulls the game core (no UI pages) from the main tree.
+
+QT += core gui widgets multimedia concurrent
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+# Benchmarks report heap allocations, so always count them (see src/frameprofiler.cpp).
+DEFINES += TE_COUNT_ALLOCATIONS
+
+GAME_ROOT = $$PWD/..
+INCLUDEPATH += $$GAME_ROOT
+
+SOURCES += \
+    $$GAME_ROOT/src/enemy.cpp \
+    $$GAME_ROOT/src/gameentity.cpp \
+    $$GAME_ROOT/src/gamemanager.cpp \
+    $$GAME_ROOT/src/resourcemanager.cpp \
+    $$GAME_ROOT/src/tower.cpp \
+    $$GAME_ROOT/src/bullet.cpp \
+    $$GAME_ROOT/src/placementvalidator.cpp \
+    $$GAME_ROOT/src/quadtree.cpp \
+    $$GAME_ROOT/src/frameprofiler.cpp \
+    $$GAME_ROOT/src/tracerecorder.cpp \
+    $$GAME_ROOT/src/logger.cpp \
+    $$GAME_ROOT/src/audiomixer.cpp \
+    $$GAME_ROOT/src/occupancygrid.cpp \
+    $$GAME_ROOT/src/flowfield.cpp \
+    $$GAME_ROOT/src/cutcellindex.cpp \
+    $$GAME_ROOT/src/lanepath.cpp \
+    $$GAME_ROOT/src/simdkernels.cpp \
+    $$GAME_ROOT/src/targetingindex.cpp
+
+HEADERS += \
+    $$GAME_ROOT/include/config.h \
+    $$GAME_ROOT/include/enemy.h \
+    $$GAME_ROOT/include/gameentity.h \
+    $$GAME_ROOT/include/gamemanager.h \
+    $$GAME_ROOT/include/resourcemanager.h \
+    $$GAME_ROOT/include/tower.h \
+    $$GAME_ROOT/include/bullet.h \
+    $$GAME_ROOT/include/placementvalidator.h \
+    $$GAME_ROOT/include/quadtree.h \
+    $$GAME_ROOT/include/frameprofiler.h \
+    $$GAME_ROOT/include/eventring.h \
+    $$GAME_ROOT/include/tracerecorder.h \
+    $$GAME_ROOT/include/logger.h \
+    $$GAME_ROOT/include/audiomixer.h \
+    $$GAME_ROOT/include/spscqueue.h \
+    $$GAME_ROOT/include/gamerandom.h \
+    $$GAME_ROOT/include/occupancygrid.h \
+    $$GAME_ROOT/include/flowfield.h \
+    $$GAME_ROOT/include/cutcellindex.h \
+    $$GAME_ROOT/include/lanepath.h \
+    $$GAME_ROOT/include/simdkernels.h \
+    $$GAME_ROOT/include/targetingindex.h \
+    $$GAME_ROOT/include/spatialindex.h \
+    $$GAME_ROOT/include/fastmath.h
+
+RESOURCES += \
+    $$GAME_ROOT/res/res.qrc
@@ -0,0 +1,1173 @@
+#include "include/config.h"
+#include "include/enemy.h"
+#include "include/tower.h"
+#include "include/bullet.h"
+#include "include/quadtree.h"
+#include "include/placementvalidator.h"
+#include "include/occupancygrid.h"
+#include "include/flowfield.h"
+#include "include/cutcellindex.h"
+#include "include/gamemanager.h"
+#include "include/simdkernels.h"
+#include "include/targetingindex.h"
+#include "include/spatialindex.h"
+#include "include/fastmath.h"
+
+#include <QtTest>
+#include <QRandomGenerator>
+#include <QPointer>
+#include <QDataStream>
+#include <QVector>
+#include <QSet>
+#include <cmath>
+
+// 核心逻辑微基准：每项在 N = 10 / 100 / 1k / 10k 下测量
+class CoreKernelsBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void quadtreeInsert_data();
+    void quadtreeInsert();
+    void quadtreeQuery_data();
+    void quadtreeQuery();
+    void spatialIndexBuild_data();
+    void spatialIndexBuild();
+    void spatialIndexRect_data();
+    void spatialIndexRect();
+    void spatialIndexNearest_data();
+    void spatialIndexNearest();
+    void spatialIndexSegment_data();
+    void spatialIndexSegment();
+    void targetingQuery_data();
+    void targetingQuery();
+    void rangeKernel_data();
+    void rangeKernel();
+    void towerFindTarget_data();
+    void towerFindTarget();
+    void enemyMoveAlongPath_data();
+    void enemyMoveAlongPath();
+    void enemyMoveAlongFlowField_data();
+    void enemyMoveAlongFlowField();
+    void flowFieldToggleCell();
+    void pathBlockQuery();
+    void bulletHoming_data();
+    void bulletHoming();
+    void bulletSweep_data();
+    void bulletSweep();
+    void analyticIntercept_data();
+    void analyticIntercept();
+    void homingKernel_data();
+    void homingKernel();
+    void progressKernel_data();
+    void progressKernel();
+    void fastMathAccuracy();
+    void rotationAngle_data();
+    void rotationAngle();
+    void turnSinCos_data();
+    void turnSinCos();
+    void placementCheck_data();
+    void placementCheck();
+    void enemySaveState_data();
+    void enemySaveState();
+
+private:
+    // 添加实体数量数据列
+    void addEntityCounts();
+    // 按本机支持的每种批量内核实现添加 1 万与 10 万实体的数据行
+    void addKernelRows();
+    // 将前 count 个敌人随机散布在地图上
+    void scatterEnemies(int count, quint32 seed);
+
+    QVector<Enemy *> enemyPool;
+    QVector<QPointF> longPath;
+    QSharedPointer<const LanePath> longLane;
+};
+
+static const int MAX_ENTITIES = 10000;
+
+void CoreKernelsBenchmark::initTestCase()
+{
+    // 敌人构造会解码贴图，只在这里创建一次并在各项中复用
+    enemyPool.reserve(MAX_ENTITIES);
+    for (int i = 0; i < MAX_ENTITIES; ++i)
+        enemyPool.append(new Enemy(i % GameConfig::ENEMY_TYPE_NUMBER, this));
+
+    // 在地图上来回折返的长路径，保证测量期间敌人不会走到终点
+    for (int row = 0; row < GameConfig::WINDOW_HEIGHT / GameConfig::GRID_SIZE; ++row)
+    {
+        qreal y = row * GameConfig::GRID_SIZE;
+        if (row % 2 == 0)
+        {
+            longPath << QPointF(0, y) << QPointF(GameConfig::WINDOW_WIDTH - GameConfig::GRID_SIZE, y);
+        }
+        else
+        {
+            longPath << QPointF(GameConfig::WINDOW_WIDTH - GameConfig::GRID_SIZE, y) << QPointF(0, y);
+        }
+    }
+    longLane = QSharedPointer<const LanePath>(new LanePath(longPath));
+}
+
+void CoreKernelsBenchmark::cleanupTestCase()
+{
+    qDeleteAll(enemyPool);
+    enemyPool.clear();
+}
+
+void CoreKernelsBenchmark::addEntityCounts()
+{
+    QTest::addColumn<int>("count");
+    QTest::newRow("N=10") << 10;
+    QTest::newRow("N=100") << 100;
+    QTest::newRow("N=1000") << 1000;
+    QTest::newRow("N=10000") << 10000;
+}
+
+void CoreKernelsBenchmark::addKernelRows()
+{
+    QTest::addColumn<int>("backend");
+    QTest::addColumn<int>("count");
+    for (int backend = SimdKernels::BACKEND_SCALAR; backend <= SimdKernels::bestSupportedBackend(); ++backend)
+    {
+        const char *name = SimdKernels::backendName(static_cast<SimdKernels::Backend>(backend));
+        QTest::newRow(QByteArray(name).append(" N=10000").constData()) << backend << 10000;
+        QTest::newRow(QByteArray(name).append(" N=100000").constData()) << backend << 100000;
+    }
+}
+
+void CoreKernelsBenchmark::scatterEnemies(int count, quint32 seed)
+{
+    QRandomGenerator rng(seed);
+    for (int i = 0; i < count; ++i)
+    {
+        enemyPool[i]->setPos(rng.bounded(double(GameConfig::WINDOW_WIDTH)),
+                             rng.bounded(double(GameConfig::WINDOW_HEIGHT)));
+    }
+}
+
+void CoreKernelsBenchmark::quadtreeInsert_data()
+{
+    addEntityCounts();
+}
+
+void CoreKernelsBenchmark::quadtreeInsert()
+{
+    QFETCH(int, count);
+    scatterEnemies(count, 1);
+
+    QRectF bounds(0, 0, GameConfig::WINDOW_WIDTH, GameConfig::WINDOW_HEIGHT);
+    QBENCHMARK
+    {
+        Quadtree tree(bounds, 4);
+        for (int i = 0; i < count; ++i)
+            tree.insert(enemyPool[i]);
+    }
+}
+
+void CoreKernelsBenchmark::quadtreeQuery_data()
+{
+    addEntityCounts();
+}
+
+void CoreKernelsBenchmark::quadtreeQuery()
+{
+    QFETCH(int, count);
+    scatterEnemies(count, 2);
+
+    QRectF bounds(0, 0, GameConfig::WINDOW_WIDTH, GameConfig::WINDOW_HEIGHT);
+    Quadtree tree(bounds, 4);
+    for (int i = 0; i < count; ++i)
+        tree.insert(enemyPool[i]);
+
+    // 模拟 64 座防御塔各自查询一次射程矩形
+    QRandomGenerator rng(3);
+    QVector<QRectF> queries;
+    qreal range = GameConfig::TowerStats::ARROW_RANGE;
+    for (int i = 0; i < 64; ++i)
+    {
+        qreal x = rng.bounded(double(GameConfig::WINDOW_WIDTH));
+        qreal y = rng.bounded(double(GameConfig::WINDOW_HEIGHT));
+        queries.append(QRectF(x - range, y - range, range * 2, range * 2));
+    }
+
+    // 每轮命中总数须与逐个判断矩形包含的结果一致
+    int expectedTotal = 0;
+    for (const QRectF &rect : queries)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            if (rect.contains(enemyPool[i]->pos()))
+                expectedTotal++;
+        }
+    }
+
+    QList<Enemy *> found;
+    int total = 0;
+    QBENCHMARK
+    {
+        total = 0;
+        for (const QRectF &rect : queries)
+        {
+            found.clear();
+            tree.query(rect, found);
+            total += found.size();
+        }
+    }
+    QCOMPARE(total, expectedTotal);
+}
+
+void CoreKernelsBenchmark::spatialIndexBuild_data()
+{
+    addEntityCounts();
+}
+
+void CoreKernelsBenchmark::spatialIndexBuild()
+{
+    QFETCH(int, count);
+    scatterEnemies(count, 1);
+
+    // 与 quadtreeInsert 同一场景；索引跨次复用，对应每帧重建
+    SpatialIndex<Enemy *> index;
+    QBENCHMARK
+    {
+        index.clear();
+        for (int i = 0; i < count; ++i)
+            index.insert(enemyPool[i], enemyPool[i]->pos());
+        index.build();
+    }
+    QCOMPARE(index.size(), count);
+}
+
+void CoreKernelsBenchmark::spatialIndexRect_data()
+{
+    addEntityCounts();
+}
+
+void CoreKernelsBenchmark::spatialIndexRect()
+{
+    QFETCH(int, count);
+    scatterEnemies(count, 2);
+
+    // 与 quadtreeQuery 同一场景：64 个射程矩形。新索引按 float 存坐标，
+    // 坐标与矩形边都取 float 能精确表示的值，贴边的点两边判定才一致
+    QRectF bounds(0, 0, GameConfig::WINDOW_WIDTH, GameConfig::WINDOW_HEIGHT);
+    Quadtree tree(bounds, 4);
+    SpatialIndex<Enemy *> index;
+    for (int i = 0; i < count; ++i)
+    {
+        enemyPool[i]->setPos(static_cast<float>(enemyPool[i]->x()), static_cast<float>(enemyPool[i]->y()));
+        tree.insert(enemyPool[i]);
+        index.insert(enemyPool[i], enemyPool[i]->pos());
+    }
+    index.build();
+
+    QRandomGenerator rng(3);
+    QVector<QRectF> queries;
+    qreal range = GameConfig::TowerStats::ARROW_RANGE;
+    for (int i = 0; i < 64; ++i)
+    {
+        qreal x = static_cast<float>(rng.bounded(double(GameConfig::WINDOW_WIDTH)));
+        qreal y = static_cast<float>(rng.bounded(double(GameConfig::WINDOW_HEIGHT)));
+        queries.append(QRectF(x - range, y - range, range * 2, range * 2));
+    }
+
+    // 旧树按象限顺序输出，比较前排序
+    QList<Enemy *> expected;
+    QVector<Enemy *> found;
+    int expectedTotal = 0;
+    for (const QRectF &rect : queries)
+    {
+        expected.clear();
+        tree.query(rect, expected);
+        expectedTotal += expected.size();
+        index.queryRect(rect, &found);
+        QVector<Enemy *> sortedExpected = expected.toVector();
+        QVector<Enemy *> sortedFound = found;
+        std::sort(sortedExpected.begin(), sortedExpected.end());
+        std::sort(sortedFound.begin(), sortedFound.end());
+        QVERIFY(sortedFound == sortedExpected);
+    }
+
+    int total = 0;
+    QBENCHMARK
+    {
+        total = 0;
+        for (const QRectF &rect : queries)
+        {
+            index.queryRect(rect, &found);
+            total += found.size();
+        }
+    }
+    QCOMPARE(total, expectedTotal);
+}
+
+void CoreKernelsBenchmark::spatialIndexNearest_data()
+{
+    addEntityCounts();
+}
+
+void CoreKernelsBenchmark::spatialIndexNearest()
+{
+    QFETCH(int, count);
+    scatterEnemies(count, 5);
+
+    SpatialIndex<int> index;
+    for (int i = 0; i < count; ++i)
+        index.insert(i, enemyPool[i]->pos());
+    index.build();
+
+    // 64 个查询点各取最近的 4 个，先与全量排序的结果对照
+    const int k = 4;
+    QRandomGenerator rng(6);
+    QVector<QPointF> queries;
+    for (int i = 0; i < 64; ++i)
+        queries.append(QPointF(rng.bounded(double(GameConfig::WINDOW_WIDTH)), rng.bounded(double(GameConfig::WINDOW_HEIGHT))));
+
+    QVector<int> found;
+    int expectedTotal = 0;
+    for (const QPointF &center : queries)
+    {
+        QVector<QPair<float, int>> all;
+        for (int i = 0; i < count; ++i)
+        {
+            float dx = static_cast<float>(enemyPool[i]->x()) - static_cast<float>(center.x());
+            float dy = static_cast<float>(enemyPool[i]->y()) - static_cast<float>(center.y());
+            all.append(qMakePair(dx * dx + dy * dy, i));
+        }
+        std::sort(all.begin(), all.end());
+        QVector<int> expected;
+        for (int i = 0; i < qMin(k, all.size()); ++i)
+            expected.append(all[i].second);
+        index.queryNearest(center, k, &found);
+        QVERIFY(found == expected);
+        expectedTotal += expected.size();
+    }
+
+    int total = 0;
+    QBENCHMARK
+    {
+        total = 0;
+        for (const QPointF &center : queries)
+        {
+            index.queryNearest(center, k, &found);
+            total += found.size();
+        }
+    }
+    QCOMPARE(total, expectedTotal);
+}
+
+void CoreKernelsBenchmark::spatialIndexSegment_data()
+{
+    addEntityCounts();
+}
+
+void CoreKernelsBenchmark::spatialIndexSegment()
+{
+    QFETCH(int, count);
+    scatterEnemies(count, 6);
+
+    SpatialIndex<int> index;
+    for (int i = 0; i < count; ++i)
+        index.insert(i, enemyPool[i]->pos());
+    index.build();
+
+    // 子弹一帧扫过的线段：长度为数帧位移，半径为两者碰撞半径之和
+    QRandomGenerator rng(7);
+    QVector<QLineF> sweeps;
+    for (int i = 0; i < 256; ++i)
+    {
+        QPointF from(rng.bounded(double(GameConfig::WINDOW_WIDTH)), rng.bounded(double(GameConfig::WINDOW_HEIGHT)));
+        sweeps.append(QLineF(from, from + QPointF(rng.bounded(64.0) - 32.0, rng.bounded(64.0) - 32.0)));
+    }
+    const qreal radius = GameConfig::ENEMY_COLLISION_RADIUS + GameConfig::BULLET_COLLISION_RADIUS;
+
+    QVector<int> found;
+    int expectedTotal = 0;
+    for (const QLineF &sweep : sweeps)
+    {
+        index.querySegment(sweep.p1(), sweep.p2(), radius, &found);
+        expectedTotal += found.size();
+        for (int i = 0; i < count; ++i)
+        {
+            // 找到的点与线段距离须在半径内，漏掉的点须在半径外（留出浮点余量）
+            QPointF offset = enemyPool[i]->pos() - sweep.p1();
+            QPointF delta = sweep.p2() - sweep.p1();
+            qreal lengthSq = QPointF::dotProduct(delta, delta);
+            qreal t = lengthSq > 0 ? qBound(0.0, QPointF::dotProduct(offset, delta) / lengthSq, 1.0) : 0.0;
+            qreal distance = QLineF(enemyPool[i]->pos(), sweep.p1() + delta * t).length();
+            if (found.contains(i))
+                QVERIFY(distance <= radius + 1e-3);
+            else
+                QVERIFY(distance >= radius - 1e-3);
+        }
+    }
+
+    int total = 0;
+    QBENCHMARK
+    {
+        total = 0;
+        for (const QLineF &sweep : sweeps)
+        {
+            index.querySegment(sweep.p1(), sweep.p2(), radius, &found);
+            total += found.size();
+        }
+    }
+    QCOMPARE(total, expectedTotal);
+}
+
+void CoreKernelsBenchmark::targetingQuery_data()
+{
+    QTest::addColumn<int>("backend");
+    QTest::addColumn<int>("count");
+    const int counts[] = {10, 100, 1000, 10000};
+    for (int backend = TargetingIndex::BACKEND_BRUTE_FORCE; backend <= TargetingIndex::BACKEND_QUADTREE; ++backend)
+    {
+        const char *name = TargetingIndex::backendName(static_cast<TargetingIndex::Backend>(backend));
+        for (int count : counts)
+            QTest::newRow(QByteArray(name).append(" N=").append(QByteArray::number(count)).constData()) << backend << count;
+    }
+}
+
+void CoreKernelsBenchmark::targetingQuery()
+{
+    QFETCH(int, backend);
+    QFETCH(int, count);
+
+    // 与 quadtreeQuery 相同的场景：一次重建加 64 座塔各查一次射程圆，部分敌人落在地图外
+    QRandomGenerator rng(2);
+    QVector<float> x(count), y(count);
+    for (int i = 0; i < count; ++i)
+    {
+        x[i] = static_cast<float>(rng.bounded(double(GameConfig::WINDOW_WIDTH + 80)) - 40.0);
+        y[i] = static_cast<float>(rng.bounded(double(GameConfig::WINDOW_HEIGHT + 80)) - 40.0);
+    }
+    QVector<QPointF> towers;
+    for (int i = 0; i < 64; ++i)
+        towers.append(QPointF(rng.bounded(double(GameConfig::WINDOW_WIDTH)), rng.bounded(double(GameConfig::WINDOW_HEIGHT))));
+    const float range = GameConfig::TowerStats::ARROW_RANGE;
+
+    // 每种实现的结果须与暴力扫描逐项相同
+    TargetingIndex reference;
+    reference.forceBackend(TargetingIndex::BACKEND_BRUTE_FORCE);
+    reference.rebuild(x, y, towers.size());
+    TargetingIndex index;
+    index.forceBackend(backend);
+    index.rebuild(x, y, towers.size());
+    QCOMPARE(static_cast<int>(index.activeBackend()), backend);
+    QVector<int> expected, found;
+    int expectedTotal = 0;
+    for (const QPointF &tower : towers)
+    {
+        reference.queryCircle(tower.x(), tower.y(), range, &expected);
+        index.queryCircle(tower.x(), tower.y(), range, &found);
+        QVERIFY(found == expected);
+        expectedTotal += expected.size();
+    }
+
+    int total = 0;
+    QBENCHMARK
+    {
+        total = 0;
+        index.rebuild(x, y, towers.size());
+        for (const QPointF &tower : towers)
+        {
+            index.queryCircle(tower.x(), tower.y(), range, &found);
+            total += found.size();
+        }
+    }
+    QCOMPARE(total, expectedTotal);
+}
+
+void CoreKernelsBenchmark::rangeKernel_data()
+{
+    addKernelRows();
+}
+
+void CoreKernelsBenchmark::rangeKernel()
+{
+    QFETCH(int, backend);
+    QFETCH(int, count);
+
+    QRandomGenerator rng(9);
+    QVector<float> x(count), y(count);
+    for (int i = 0; i < count; ++i)
+    {
+        x[i] = static_cast<float>(rng.bounded(double(GameConfig::WINDOW_WIDTH)));
+        y[i] = static_cast<float>(rng.bounded(double(GameConfig::WINDOW_HEIGHT)));
+    }
+    const float centerX = GameConfig::WINDOW_WIDTH / 2.0f;
+    const float centerY = GameConfig::WINDOW_HEIGHT / 2.0f;
+    const float radiusSq = float(GameConfig::TowerStats::ARROW_RANGE) * GameConfig::TowerStats::ARROW_RANGE;
+
+    QVector<qint32> reference(count);
+    SimdKernels::setBackend(SimdKernels::BACKEND_SCALAR);
+    reference.resize(SimdKernels::collectInRange(x.constData(), y.constData(), count, centerX, centerY, radiusSq, reference.data()));
+
+    QCOMPARE(static_cast<int>(SimdKernels::setBackend(static_cast<SimdKernels::Backend>(backend))), backend);
+    QVector<qint32> found(count);
+    found.resize(SimdKernels::collectInRange(x.constData(), y.constData(), count, centerX, centerY, radiusSq, found.data()));
+    QVERIFY(found == reference);
+
+    found.resize(count);
+    QBENCHMARK
+    {
+        SimdKernels::collectInRange(x.constData(), y.constData(), count, centerX, centerY, radiusSq, found.data());
+    }
+
+    SimdKernels::setBackend(SimdKernels::bestSupportedBackend());
+}
+
+void CoreKernelsBenchmark::towerFindTarget_data()
+{
+    addEntityCounts();
+}
+
+void CoreKernelsBenchmark::towerFindTarget()
+{
+    QFETCH(int, count);
+
+    QPointF center(GameConfig::WINDOW_WIDTH / 2.0, GameConfig::WINDOW_HEIGHT / 2.0);
+    Tower tower(Tower::ARROW_TOWER, center);
+
+    // 全部敌人放在射程内，测量完整的候选扫描
+    QRandomGenerator rng(4);
+    QList<QPointer<Enemy>> inRange;
+    qreal radius = tower.getRange() * 0.9;
+    for (int i = 0; i < count; ++i)
+    {
+        qreal angle = rng.bounded(2.0 * M_PI);
+        qreal r = rng.bounded(radius);
+        enemyPool[i]->setPos(center.x() + r * std::cos(angle), center.y() + r * std::sin(angle));
+        inRange.append(enemyPool[i]);
+    }
+
+    QBENCHMARK
+    {
+        tower.setTarget(nullptr);
+        tower.setEnemiesInRange(inRange);
+        tower.update();
+    }
+
+    for (int i = 0; i < count; ++i)
+        enemyPool[i]->setHighlighted(false);
+}
+
+void CoreKernelsBenchmark::enemyMoveAlongPath_data()
+{
+    addEntityCounts();
+}
+
+void CoreKernelsBenchmark::enemyMoveAlongPath()
+{
+    QFETCH(int, count);
+
+    for (int i = 0; i < count; ++i)
+        enemyPool[i]->setPath(longLane);
+
+    QBENCHMARK
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            Enemy *enemy = enemyPool[i];
+            enemy->moveAlongPath();
+            if (enemy->isAtEnd())
+                enemy->setPath(longLane);
+        }
+    }
+}
+
+void CoreKernelsBenchmark::enemyMoveAlongFlowField_data()
+{
+    addEntityCounts();
+}
+
+void CoreKernelsBenchmark::enemyMoveAlongFlowField()
+{
+    QFETCH(int, count);
+
+    // 所有敌人共用一张流场，每步只读相邻四格
+    OccupancyGrid grid = OccupancyGrid::buildForMap(GameConfig::MAP3);
+    const GameConfig::GridPoint goal = GameConfig::MapPaths::LANE_MAP.value(GameConfig::MAP3).first().last();
+    FlowField field;
+    field.reset(grid, QVector<QPoint>() << QPoint(goal.gridX, goal.gridY));
+
+    const QVector<QPointF> path = GameManager::buildLanePaths(GameConfig::MAP3).first()->points();
+    const QPointF spawn = path.first();
+    for (int i = 0; i < count; ++i)
+    {
+        enemyPool[i]->setPos(spawn);
+        enemyPool[i]->setFlowField(&field);
+    }
+
+    QBENCHMARK
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            Enemy *enemy = enemyPool[i];
+            enemy->moveAlongPath();
+            if (enemy->pos() == path.last())
+                enemy->setPos(spawn);
+        }
+    }
+
+    for (int i = 0; i < count; ++i)
+        enemyPool[i]->setFlowField(nullptr);
+}
+
+void CoreKernelsBenchmark::flowFieldToggleCell()
+{
+    // 在开阔地图中央反复建塔、拆塔，来回之后须与整体重算一致
+    OccupancyGrid grid = OccupancyGrid::buildForMap(GameConfig::MAP3);
+    const GameConfig::GridPoint goal = GameConfig::MapPaths::LANE_MAP.value(GameConfig::MAP3).first().last();
+    const QVector<QPoint> goals = QVector<QPoint>() << QPoint(goal.gridX, goal.gridY);
+    FlowField field;
+    field.reset(grid, goals);
+
+    const int cellX = grid.columns() / 2;
+    const int cellY = goal.gridY;
+    QBENCHMARK
+    {
+        field.blockCell(cellX, cellY);
+        field.unblockCell(cellX, cellY);
+    }
+
+    FlowField reference;
+    reference.reset(grid, goals);
+    for (int y = 0; y < grid.rows(); ++y)
+    {
+        for (int x = 0; x < grid.columns(); ++x)
+            QCOMPARE(field.distance(x, y), reference.distance(x, y));
+    }
+}
+
+void CoreKernelsBenchmark::pathBlockQuery()
+{
+    // 悬停判定：对开阔地图每一格问一次“堵住它会不会断路”
+    OccupancyGrid grid = OccupancyGrid::buildForMap(GameConfig::MAP3);
+    const QVector<GameConfig::GridPoint> lane = GameConfig::MapPaths::LANE_MAP.value(GameConfig::MAP3).first();
+    const GameConfig::GridPoint spawn = lane.first();
+    const GameConfig::GridPoint goal = lane.last();
+    const QVector<QPoint> goals = QVector<QPoint>() << QPoint(goal.gridX, goal.gridY);
+    FlowField field;
+    field.reset(grid, goals);
+    CutCellIndex index;
+    index.rebuild(field, goals);
+
+    int cutting = 0;
+    QBENCHMARK
+    {
+        cutting = 0;
+        for (int y = 0; y < grid.rows(); ++y)
+        {
+            for (int x = 0; x < grid.columns(); ++x)
+            {
+                if (index.separates(QPoint(x, y), QPoint(spawn.gridX, spawn.gridY)))
+                    cutting++;
+            }
+        }
+    }
+
+    // 空旷场地上只有终点格本身能切断出生点
+    QCOMPARE(cutting, 1);
+}
+
+void CoreKernelsBenchmark::bulletHoming_data()
+{
+    addEntityCounts();
+}
+
+void CoreKernelsBenchmark::bulletHoming()
+{
+    QFETCH(int, count);
+
+    QRandomGenerator rng(5);
+    QVector<QPointF> directions;
+    QVector<QPointF> toTargets;
+    for (int i = 0; i < count; ++i)
+    {
+        qreal angle = rng.bounded(2.0 * M_PI);
+        directions.append(QPointF(std::cos(angle), std::sin(angle)));
+        // 目标大致位于前方，覆盖需要转向与无需转向两种情况
+        qreal offset = angle + rng.bounded(M_PI) - M_PI / 2.0;
+        qreal distance = 20.0 + rng.bounded(300.0);
+        toTargets.append(QPointF(std::cos(offset) * distance, std::sin(offset) * distance));
+    }
+
+    qreal maxTurnRad = GameConfig::BULLET_MAX_TURN_DEG * M_PI / 180.0;
+    QVector<QPointF> results(count);
+    QBENCHMARK
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            QPointF steered = directions[i];
+            Bullet::steerTowards(directions[i], toTargets[i], maxTurnRad, &steered);
+            results[i] = steered;
+        }
+    }
+    QVERIFY(results.size() == count);
+}
+
+void CoreKernelsBenchmark::bulletSweep_data()
+{
+    addEntityCounts();
+}
+
+void CoreKernelsBenchmark::bulletSweep()
+{
+    QFETCH(int, count);
+
+    // 单步位移远大于碰撞直径时，离散检测会从圆心旁边跳过去，扫掠检测必须接住
+    const qreal radius = GameConfig::ENEMY_COLLISION_RADIUS + GameConfig::BULLET_COLLISION_RADIUS;
+    qreal time = -1.0;
+    QVERIFY(Bullet::sweepCircle(QPointF(0, 0), QPointF(400, 0), QPointF(200, 10), radius, &time));
+    QVERIFY(qAbs(time - (200.0 - std::sqrt(radius * radius - 100.0)) / 400.0) < 1e-9);
+    QVERIFY(Bullet::sweepCircle(QPointF(195, 0), QPointF(400, 0), QPointF(200, 0), radius, &time));
+    QCOMPARE(time, 0.0);
+    QVERIFY(!Bullet::sweepCircle(QPointF(0, 0), QPointF(400, 0), QPointF(200, radius + 1.0), radius, &time));
+    QVERIFY(!Bullet::sweepCircle(QPointF(0, 0), QPointF(100, 0), QPointF(200, 0), radius, &time));
+    QVERIFY(!Bullet::sweepCircle(QPointF(300, 0), QPointF(400, 0), QPointF(200, 0), radius, &time));
+
+    // 与 GameManager 相同的两段式：敌人中心建宽相位索引，每颗子弹查线段候选再精确求交
+    scatterEnemies(count, 8);
+    SpatialIndex<Enemy *> colliders;
+    for (int i = 0; i < count; ++i)
+        colliders.insert(enemyPool[i], enemyPool[i]->getCenterPosition());
+    colliders.build();
+
+    QRandomGenerator rng(9);
+    QVector<QLineF> sweeps;
+    for (int i = 0; i < 256; ++i)
+    {
+        QPointF from(rng.bounded(double(GameConfig::WINDOW_WIDTH)), rng.bounded(double(GameConfig::WINDOW_HEIGHT)));
+        qreal angle = rng.bounded(2.0 * M_PI);
+        sweeps.append(QLineF(from, from + QPointF(std::cos(angle), std::sin(angle)) * GameConfig::BULLET_SPEED));
+    }
+
+    // 逐个敌人精确求交得到的命中子弹数，宽相位不能漏掉其中任何一颗
+    int expectedHits = 0;
+    for (const QLineF &sweep : sweeps)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            if (Bullet::sweepCircle(sweep.p1(), sweep.p2(), enemyPool[i]->getCenterPosition(), radius, &time))
+            {
+                expectedHits++;
+                break;
+            }
+        }
+    }
+
+    QVector<Enemy *> candidates;
+    int hits = 0;
+    QBENCHMARK
+    {
+        hits = 0;
+        for (const QLineF &sweep : sweeps)
+        {
+            colliders.querySegment(sweep.p1(), sweep.p2(), radius + 1.0, &candidates);
+            for (Enemy *enemy : candidates)
+            {
+                if (Bullet::sweepCircle(sweep.p1(), sweep.p2(), enemy->getCenterPosition(), radius, &time))
+                {
+                    hits++;
+                    break;
+                }
+            }
+        }
+    }
+    QCOMPARE(hits, expectedHits);
+}
+
+void CoreKernelsBenchmark::analyticIntercept_data()
+{
+    addEntityCounts();
+}
+
+void CoreKernelsBenchmark::analyticIntercept()
+{
+    QFETCH(int, count);
+    const int tickMs = GameConfig::GAME_TICK_INTERVAL_MS;
+    const qreal hitRadius = GameConfig::ENEMY_COLLISION_RADIUS + GameConfig::BULLET_COLLISION_RADIUS;
+
+    // 敌人散布在长路线前半段，子弹从射程内的随机位置开火；伤害为 0，不影响后续测量
+    QRandomGenerator rng(10);
+    QVector<Bullet *> shots;
+    QVector<QPointF> launches;
+    int planned = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        Enemy *enemy = enemyPool[i];
+        enemy->setFlowField(nullptr);
+        enemy->setPath(longLane);
+        enemy->setProgress(static_cast<float>(rng.bounded(longLane->totalLength() * 0.5)));
+        qreal angle = rng.bounded(2.0 * M_PI);
+        qreal distance = rng.bounded(double(GameConfig::TowerStats::ARROW_RANGE));
+        QPointF launch = enemy->getCenterPosition() + QPointF(std::cos(angle), std::sin(angle)) * distance;
+        Bullet *bullet = new Bullet(Bullet::BULLET_ARROW, launch, QPointF(0, -1), enemy, 0, this);
+        if (bullet->planIntercept(tickMs))
+            planned++;
+        shots.append(bullet);
+        launches.append(launch);
+    }
+    QCOMPARE(planned, count);
+
+    // 每帧只做一次插值，对照 bulletHoming 的逐步追踪开销
+    QBENCHMARK
+    {
+        for (Bullet *bullet : shots)
+            bullet->advanceFlight(0);
+    }
+
+    // 按模拟顺序推进：开火当帧子弹先走一次，之后每帧敌人先走 (节拍步数 + 1) 步、子弹再走；
+    // 命中那一帧直线飞行的累计距离必须够得着敌人当时的中心
+    int remaining = count;
+    for (int tick = 1; remaining > 0; ++tick)
+    {
+        QVERIFY(tick < 1000);
+        for (int i = 0; i < count; ++i)
+        {
+            Bullet *bullet = shots[i];
+            if (bullet->isFinished())
+                continue;
+
+            Enemy *enemy = enemyPool[i];
+            if (tick > 1)
+            {
+                int steps = enemy->takeMoveSteps(tickMs) + 1;
+                enemy->setProgress(enemy->getProgress() + enemy->getSpeed() * steps);
+            }
+            bullet->advanceFlight(tickMs);
+            if (!bullet->isFinished())
+                continue;
+
+            QPointF toEnemy = enemy->getCenterPosition() - launches[i];
+            qreal reach = GameConfig::BULLET_SPEED * ((tick * tickMs) / GameConfig::BULLET_MOVE_INTERVAL);
+            QVERIFY(std::sqrt(QPointF::dotProduct(toEnemy, toEnemy)) <= reach + hitRadius + 1e-3);
+            remaining--;
+        }
+    }
+}
+
+void CoreKernelsBenchmark::homingKernel_data()
+{
+    addKernelRows();
+}
+
+void CoreKernelsBenchmark::homingKernel()
+{
+    QFETCH(int, backend);
+    QFETCH(int, count);
+
+    // 与 bulletHoming 同样的场景，但整批子弹存成连续数组一次推进
+    QRandomGenerator rng(5);
+    QVector<float> x(count), y(count), dirX(count), dirY(count), targetX(count), targetY(count);
+    QVector<float> speed(count, GameConfig::BULLET_SPEED);
+    QVector<qint32> tracking(count), hit(count);
+    for (int i = 0; i < count; ++i)
+    {
+        qreal angle = rng.bounded(2.0 * M_PI);
+        x[i] = rng.bounded(double(GameConfig::WINDOW_WIDTH));
+        y[i] = rng.bounded(double(GameConfig::WINDOW_HEIGHT));
+        dirX[i] = std::cos(angle);
+        dirY[i] = std::sin(angle);
+        qreal offset = angle + rng.bounded(M_PI) - M_PI / 2.0;
+        qreal distance = 20.0 + rng.bounded(300.0);
+        targetX[i] = x[i] + std::cos(offset) * distance;
+        targetY[i] = y[i] + std::sin(offset) * distance;
+    }
+
+    const float hitRadius = GameConfig::ENEMY_COLLISION_RADIUS + GameConfig::BULLET_COLLISION_RADIUS;
+    const float maxTurnRad = GameConfig::BULLET_MAX_TURN_DEG * M_PI / 180.0;
+    const float cosMaxTurn = std::cos(maxTurnRad);
+    const float sinMaxTurn = std::sin(maxTurnRad);
+
+    // 先用标量实现算出一步的参考结果，向量实现必须逐位一致
+    QVector<float> refX = x, refY = y, refDirX = dirX, refDirY = dirY;
+    QVector<qint32> refTracking(count, 1), refHit(count);
+    SimdKernels::HomingBatch reference = {
+        refX.data(), refY.data(), refDirX.data(), refDirY.data(), targetX.constData(), targetY.constData(),
+        speed.constData(), refTracking.data(), refHit.data(), count
+    };
+    SimdKernels::setBackend(SimdKernels::BACKEND_SCALAR);
+    SimdKernels::stepHoming(reference, hitRadius, cosMaxTurn, sinMaxTurn);
+
+    QCOMPARE(static_cast<int>(SimdKernels::setBackend(static_cast<SimdKernels::Backend>(backend))), backend);
+    QVector<float> stepX = x, stepY = y, stepDirX = dirX, stepDirY = dirY;
+    QVector<qint32> stepTracking(count, 1), stepHit(count);
+    SimdKernels::HomingBatch batch = {
+        stepX.data(), stepY.data(), stepDirX.data(), stepDirY.data(), targetX.constData(), targetY.constData(),
+        speed.constData(), stepTracking.data(), stepHit.data(), count
+    };
+    SimdKernels::stepHoming(batch, hitRadius, cosMaxTurn, sinMaxTurn);
+    QVERIFY(stepX == refX && stepY == refY && stepDirX == refDirX && stepDirY == refDirY);
+    QVERIFY(stepTracking == refTracking && stepHit == refHit);
+
+    // 每轮从同一初始状态出发，计时包含恢复四个坐标数组的拷贝
+    QBENCHMARK
+    {
+        stepX = x;
+        stepY = y;
+        stepDirX = dirX;
+        stepDirY = dirY;
+        tracking.fill(1);
+        batch.x = stepX.data();
+        batch.y = stepY.data();
+        batch.dirX = stepDirX.data();
+        batch.dirY = stepDirY.data();
+        batch.tracking = tracking.data();
+        batch.hit = hit.data();
+        SimdKernels::stepHoming(batch, hitRadius, cosMaxTurn, sinMaxTurn);
+    }
+
+    SimdKernels::setBackend(SimdKernels::bestSupportedBackend());
+}
+
+void CoreKernelsBenchmark::progressKernel_data()
+{
+    addKernelRows();
+}
+
+void CoreKernelsBenchmark::progressKernel()
+{
+    QFETCH(int, backend);
+    QFETCH(int, count);
+
+    // 沿路线敌人每帧只推进弧长：progress = min(progress + speed * steps, length)
+    QRandomGenerator rng(8);
+    QVector<float> progress(count), speed(count), steps(count), length(count);
+    for (int i = 0; i < count; ++i)
+    {
+        length[i] = static_cast<float>(longLane->totalLength());
+        progress[i] = static_cast<float>(rng.bounded(double(length[i])));
+        speed[i] = GameConfig::ENEMY_SPEED * (1.0f + 0.1f * rng.bounded(10));
+        steps[i] = static_cast<float>(1 + rng.bounded(2));
+    }
+
+    QVector<float> reference = progress;
+    SimdKernels::setBackend(SimdKernels::BACKEND_SCALAR);
+    SimdKernels::advanceProgress(reference.data(), speed.constData(), steps.constData(), length.constData(), count);
+
+    QCOMPARE(static_cast<int>(SimdKernels::setBackend(static_cast<SimdKernels::Backend>(backend))), backend);
+    QVector<float> advanced = progress;
+    SimdKernels::advanceProgress(advanced.data(), speed.constData(), steps.constData(), length.constData(), count);
+    QVERIFY(advanced == reference);
+
+    QBENCHMARK
+    {
+        SimdKernels::advanceProgress(advanced.data(), speed.constData(), steps.constData(), length.constData(), count);
+    }
+
+    SimdKernels::setBackend(SimdKernels::bestSupportedBackend());
+}
+
+void CoreKernelsBenchmark::fastMathAccuracy()
+{
+    // 对照 <cmath> 的双精度结果校验 fastmath.h 注释里写明的误差上限
+    QRandomGenerator rng(9);
+    double atanError = 0;
+    double sinCosError = 0;
+    double rsqrtError = 0;
+    double wrapError = 0;
+    for (int i = 0; i < 200000; ++i)
+    {
+        float y = static_cast<float>(rng.bounded(2000.0) - 1000.0);
+        float x = static_cast<float>(rng.bounded(2000.0) - 1000.0);
+        if (i % 3 == 0)
+            x *= 1e-3f;
+        atanError = qMax(atanError, std::fabs(FastMath::atan2(y, x) - std::atan2(double(y), double(x))));
+
+        float angle = static_cast<float>(rng.bounded(2e4) - 1e4);
+        if (i % 2 == 0)
+            angle *= 1e-3f;
+        float s = 0.0f;
+        float c = 0.0f;
+        FastMath::sincos(angle, &s, &c);
+        sinCosError = qMax(sinCosError, std::fabs(s - std::sin(double(angle))));
+        sinCosError = qMax(sinCosError, std::fabs(c - std::cos(double(angle))));
+
+        float wrapped = FastMath::wrapRadians(angle);
+        QVERIFY(std::fabs(wrapped) <= FastMath::PI);
+        double wrapDiff = std::fabs(wrapped - std::remainder(double(angle), 2.0 * M_PI));
+        wrapError = qMax(wrapError, qMin(wrapDiff, std::fabs(wrapDiff - 2.0 * M_PI)));
+
+        float value = std::pow(2.0f, static_cast<float>(rng.bounded(60.0) - 30.0));
+        rsqrtError = qMax(rsqrtError, std::fabs(FastMath::rsqrt(value) * std::sqrt(double(value)) - 1.0));
+    }
+    QVERIFY2(atanError <= 1.2e-5, QByteArray::number(atanError).constData());
+    QVERIFY2(sinCosError <= 5.0e-7, QByteArray::number(sinCosError).constData());
+    QVERIFY2(rsqrtError <= 5.0e-6, QByteArray::number(rsqrtError).constData());
+    QVERIFY2(wrapError <= 1.0e-6, QByteArray::number(wrapError).constData());
+
+    QCOMPARE(FastMath::atan2(0.0f, 0.0f), 0.0f);
+    QVERIFY(std::fabs(FastMath::atan2(0.0f, -1.0f) - FastMath::PI) < 1e-5f);
+    QCOMPARE(FastMath::wrapDegrees(190.0), -170.0);
+    QCOMPARE(FastMath::wrapDegrees(-190.0), 170.0);
+}
+
+void CoreKernelsBenchmark::rotationAngle_data()
+{
+    QTest::addColumn<bool>("fast");
+    QTest::newRow("cmath N=10000") << false;
+    QTest::newRow("fastmath N=10000") << true;
+}
+
+void CoreKernelsBenchmark::rotationAngle()
+{
+    QFETCH(bool, fast);
+
+    // 塔与子弹每帧由方向向量求朝向角
+    QRandomGenerator rng(10);
+    QVector<QPointF> directions;
+    for (int i = 0; i < 10000; ++i)
+        directions.append(QPointF(rng.bounded(2.0) - 1.0, rng.bounded(2.0) - 1.0));
+
+    qreal sum = 0;
+    QBENCHMARK
+    {
+        sum = 0;
+        for (const QPointF &direction : directions)
+        {
+            if (fast)
+                sum += FastMath::atan2Degrees(direction.y(), direction.x());
+            else
+                sum += std::atan2(direction.y(), direction.x()) * 180.0 / M_PI;
+        }
+    }
+    QVERIFY(std::isfinite(sum));
+}
+
+void CoreKernelsBenchmark::turnSinCos_data()
+{
+    QTest::addColumn<bool>("fast");
+    QTest::newRow("cmath N=10000") << false;
+    QTest::newRow("fastmath N=10000") << true;
+}
+
+void CoreKernelsBenchmark::turnSinCos()
+{
+    QFETCH(bool, fast);
+
+    // 开火方向与限角转向需要同一角度的正弦和余弦
+    QRandomGenerator rng(11);
+    QVector<float> angles;
+    for (int i = 0; i < 10000; ++i)
+        angles.append(static_cast<float>(rng.bounded(4.0 * M_PI) - 2.0 * M_PI));
+
+    float sum = 0;
+    QBENCHMARK
+    {
+        sum = 0;
+        for (float angle : angles)
+        {
+            float s = 0.0f;
+            float c = 0.0f;
+            if (fast)
+            {
+                FastMath::sincos(angle, &s, &c);
+            }
+            else
+            {
+                s = std::sin(angle);
+                c = std::cos(angle);
+            }
+            sum += s + c;
+        }
+    }
+    QVERIFY(std::isfinite(sum));
+}
+
+void CoreKernelsBenchmark::placementCheck_data()
+{
+    addEntityCounts();
+}
+
+void CoreKernelsBenchmark::placementCheck()
+{
+    QFETCH(int, count);
+
+    // 可建造网格与查询点都按数量 N 生成
+    QRandomGenerator rng(6);
+    int columns = GameConfig::WINDOW_WIDTH / GameConfig::GRID_SIZE;
+    int rows = GameConfig::WINDOW_HEIGHT / GameConfig::GRID_SIZE;
+    QVector<GameConfig::GridPoint> grids;
+    for (int i = 0; i < count; ++i)
+    {
+        GameConfig::GridPoint point = {rng.bounded(columns * 8), rng.bounded(rows * 8)};
+        grids.append(point);
+    }
+
+    PlacementValidator validator;
+    validator.loadConfig(grids);
+
+    QVector<QPoint> queries;
+    for (int i = 0; i < count; ++i)
+        queries.append(QPoint(rng.bounded(columns * 8 * GameConfig::GRID_SIZE),
+                              rng.bounded(rows * 8 * GameConfig::GRID_SIZE)));
+
+    // 查询点所在格出现在生成列表里即可建造
+    QSet<QPair<int, int>> gridSet;
+    for (const GameConfig::GridPoint &point : grids)
+        gridSet.insert(qMakePair(point.gridX, point.gridY));
+    int expectedAllowed = 0;
+    for (const QPoint &point : queries)
+    {
+        if (gridSet.contains(qMakePair(point.x() / GameConfig::GRID_SIZE, point.y() / GameConfig::GRID_SIZE)))
+            expectedAllowed++;
+    }
+
+    int allowed = 0;
+    QBENCHMARK
+    {
+        allowed = 0;
+        for (const QPoint &point : queries)
+        {
+            if (validator.isPlacementAllowed(point.x(), point.y()))
+                allowed++;
+        }
+    }
+    QCOMPARE(allowed, expectedAllowed);
+}
+
+void CoreKernelsBenchmark::enemySaveState_data()
+{
+    addEntityCounts();
+}
+
+void CoreKernelsBenchmark::enemySaveState()
+{
+    QFETCH(int, count);
+    scatterEnemies(count, 7);
+
+    // 与 GameManager::saveState 相同的流设置；敌人是存档里数量最多的实体
+    QByteArray data;
+    QBENCHMARK
+    {
+        data.clear();
+        data.reserve(count * 32);
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_5_12);
+        out.setByteOrder(QDataStream::LittleEndian);
+        out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+        for (int i = 0; i < count; ++i)
+            enemyPool[i]->saveState(out);
+    }
+
+    // 读回第一个敌人，确认格式自洽
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_5_12);
+    in.setByteOrder(QDataStream::LittleEndian);
+    in.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    Enemy *restored = Enemy::restoreState(in, QVector<QSharedPointer<const LanePath>>() << longLane, nullptr);
+    QVERIFY(restored);
+    QCOMPARE(restored->getEnemyType(), enemyPool[0]->getEnemyType());
+    QCOMPARE(restored->pos().toPoint(), enemyPool[0]->pos().toPoint());
+    delete restored;
+}
+
+QTEST_MAIN(CoreKernelsBenchmark)
+
+#include "bench_corekernels.moc"
@@ -0,0 +1,14 @@
+# Qt Test micro-benchmarks for the core simulation kernels.
+#
+# Run headless and keep machine-readable results, e.g.:
+#   QT_QPA_PLATFORM=offscreen ./bench_corekernels -o corekernels.xml,xml -o -,txt
+# (csv output is also available: -o corekernels.csv,csv)
+
+include(../bench.pri)
+
+QT += testlib
+
+TARGET = bench_corekernels
+
+SOURCES += \
+    bench_corekernels.cpp
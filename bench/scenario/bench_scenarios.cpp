@@ -0,0 +1,390 @@
+#include "include/config.h"
+#include "include/gamemanager.h"
+#include "include/resourcemanager.h"
+#include "include/frameprofiler.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGraphicsScene>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QTextStream>
+#include <QVector>
+#include <algorithm>
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+#include <sys/resource.h>
+#endif
+
+#ifndef BENCH_BASELINE_PATH
+#define BENCH_BASELINE_PATH "baseline.json"
+#endif
+
+namespace
+{
+    // 一个可回放的固定关卡配置
+    struct Scenario
+    {
+        const char *name;
+        GameConfig::MapId mapId;
+        int towerStride;         // 每隔多少个可建造格放一座塔
+        int upgradeCount;        // 每座塔升级次数
+        int waveEnemyCount;      // 0 表示使用默认每波数量
+        int spawnIntervalMs;     // 0 表示使用默认刷怪间隔
+        int lives;               // 0 表示使用默认生命
+        int maxTicks;            // 兜底的最大帧数
+    };
+
+    const Scenario SCENARIOS[] = {
+        // 地图 1 完整通关，塔位稀疏
+        {"map1_full", GameConfig::MAP1, 3, 0, 0, 0, 0, 20000},
+        // 地图 2 所有可建造格放满顶级塔
+        {"map2_max_towers", GameConfig::MAP2, 1, 2, 0, 0, 0, 20000},
+        // 地图 1 单波一万敌人压力测试
+        {"stress_10k", GameConfig::MAP1, 2, 1, 10000, 1, 1000000, 4000},
+    };
+
+    const quint32 SCENARIO_SEED = 20240601u;
+
+    const Scenario *findScenario(const QString &name)
+    {
+        for (const Scenario &scenario : SCENARIOS)
+        {
+            if (name == QLatin1String(scenario.name))
+                return &scenario;
+        }
+        return nullptr;
+    }
+
+    // 进程峰值常驻内存（KB），无法获取时返回 -1
+    qint64 peakRssKb()
+    {
+#if defined(Q_OS_LINUX)
+        QFile status("/proc/self/status");
+        if (status.open(QIODevice::ReadOnly | QIODevice::Text))
+        {
+            const QList<QByteArray> lines = status.readAll().split('\n');
+            for (const QByteArray &line : lines)
+            {
+                if (line.startsWith("VmHWM:"))
+                    return line.mid(6).trimmed().split(' ').first().toLongLong();
+            }
+        }
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0)
+            return usage.ru_maxrss;
+#elif defined(Q_OS_MACOS)
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0)
+            return usage.ru_maxrss / 1024;
+#endif
+        return -1;
+    }
+
+    qint64 percentile(QVector<qint64> samples, int pct)
+    {
+        if (samples.isEmpty())
+            return 0;
+        std::sort(samples.begin(), samples.end());
+        int index = (samples.size() * pct + 99) / 100 - 1;
+        return samples[qBound(0, index, samples.size() - 1)];
+    }
+
+    // 在当前进程内回放一个场景并返回测量结果
+    QJsonObject runScenario(const Scenario &scenario)
+    {
+        QGraphicsScene scene(0, 0, GameConfig::WINDOW_WIDTH, GameConfig::WINDOW_HEIGHT);
+        GameManager manager;
+        manager.setRandomSeed(SCENARIO_SEED);
+        manager.initialize(scenario.mapId,
+                           GameManager::buildLanePaths(scenario.mapId),
+                           GameManager::buildEndPoints(scenario.mapId));
+
+        // 与 GamePage 相同的场景挂接，但死亡敌人立即回收
+        QObject::connect(&manager, &GameManager::enemySpawnRequested, [&scene](QPointer<Enemy> enemy) {
+            if (enemy)
+                scene.addItem(enemy);
+        });
+        auto discardEnemy = [&scene](QPointer<Enemy> enemy) {
+            if (!enemy)
+                return;
+            scene.removeItem(enemy);
+            enemy->deleteLater();
+        };
+        QObject::connect(&manager, &GameManager::enemyReachedEnd, discardEnemy);
+        QObject::connect(&manager, &GameManager::enemyDied, discardEnemy);
+        QObject::connect(&manager, &GameManager::towerBuilt, [&scene](QPointer<Tower> tower) {
+            scene.addItem(tower->getBaseItem());
+            scene.addItem(tower);
+        });
+        QObject::connect(&manager, &GameManager::towerUpgraded, [&scene](QPointer<Tower> oldTower, QPointer<Tower> newTower) {
+            if (oldTower)
+            {
+                scene.removeItem(oldTower);
+                oldTower->deleteLater();
+            }
+            scene.addItem(newTower->getBaseItem());
+            scene.addItem(newTower);
+            newTower->setGameScene(&scene);
+        });
+
+        bool finished = false;
+        QString outcome = "timeout";
+        QObject::connect(&manager, &GameManager::levelCompleted, [&](GameConfig::MapId, int) {
+            finished = true;
+            outcome = "completed";
+        });
+        QObject::connect(&manager, &GameManager::gameOver, [&]() {
+            finished = true;
+            outcome = "gameOver";
+        });
+
+        // 固定塔位布局，金币只用于放塔，放完恢复默认
+        QObject towerParent;
+        manager.setGold(1 << 30);
+        const QVector<GameConfig::GridPoint> buildable = GameConfig::Placement::BUILDABLE_MAP.value(scenario.mapId);
+        for (int i = 0; i < buildable.size(); i += scenario.towerStride)
+        {
+            QPointF position(buildable[i].gridX * GameConfig::GRID_SIZE, buildable[i].gridY * GameConfig::GRID_SIZE);
+            QPointer<Tower> tower = manager.buildTower(Tower::ARROW_TOWER, position, &towerParent);
+            if (!tower)
+                continue;
+            tower->setGameScene(&scene);
+            for (int level = 0; level < scenario.upgradeCount && tower; ++level)
+                tower = manager.upgradeTower(tower);
+        }
+        manager.setGold(GameConfig::INITIAL_GOLD);
+        if (scenario.lives > 0)
+            manager.setLives(scenario.lives);
+        manager.setWaveOverride(scenario.waveEnemyCount, scenario.spawnIntervalMs);
+
+        manager.startGame();
+
+        QVector<qint64> tickNs;
+        tickNs.reserve(scenario.maxTicks);
+        qint64 simulatedNs = 0;
+        quint64 allocationsBefore = FrameProfiler::allocationCount();
+
+        QElapsedTimer tickTimer;
+        while (!finished && tickNs.size() < scenario.maxTicks)
+        {
+            tickTimer.start();
+            manager.stepSimulation(GameConfig::GAME_TICK_INTERVAL_MS);
+            qint64 elapsed = tickTimer.nsecsElapsed();
+            tickNs.append(elapsed);
+            simulatedNs += elapsed;
+
+            // 无事件循环时手动回收命中的子弹与移除的敌人
+            QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        }
+
+        quint64 allocations = FrameProfiler::allocationCount() - allocationsBefore;
+
+        QJsonObject result;
+        result["scenario"] = QString::fromLatin1(scenario.name);
+        result["outcome"] = outcome;
+        result["ticks"] = tickNs.size();
+        result["wave"] = manager.getCurrentWave();
+        result["kills"] = manager.getKillCount();
+        result["ticksPerSecond"] = simulatedNs > 0 ? tickNs.size() * 1e9 / simulatedNs : 0.0;
+        result["p50TickUs"] = percentile(tickNs, 50) / 1000.0;
+        result["p99TickUs"] = percentile(tickNs, 99) / 1000.0;
+        result["peakRssKb"] = double(peakRssKb());
+        result["allocations"] = double(allocations);
+        return result;
+    }
+
+    // 在子进程中运行场景，保证峰值内存互不干扰
+    QJsonObject runScenarioInChild(const Scenario &scenario)
+    {
+        QProcess child;
+        child.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+        child.start(QCoreApplication::applicationFilePath(),
+                    QStringList() << "--scenario" << QString::fromLatin1(scenario.name));
+        if (!child.waitForFinished(-1) || child.exitCode() != 0)
+        {
+            QJsonObject failed;
+            failed["scenario"] = QString::fromLatin1(scenario.name);
+            failed["outcome"] = "crashed";
+            return failed;
+        }
+
+        return QJsonDocument::fromJson(child.readAllStandardOutput().trimmed()).object();
+    }
+
+    // 越大越好的指标只检查下降
+    bool isHigherBetter(const QString &metric)
+    {
+        return metric == "ticksPerSecond";
+    }
+
+    // 与基线比较，返回回归条数；基线缺项默认也算失败，allowMissing 时只报告
+    int compareWithBaseline(const QJsonArray &results, const QJsonObject &baseline, bool allowMissing, QTextStream &out)
+    {
+        const QJsonObject tolerance = baseline["tolerance"].toObject();
+        const QJsonObject scenarios = baseline["scenarios"].toObject();
+        int regressions = 0;
+
+        for (const QJsonValue &value : results)
+        {
+            const QJsonObject result = value.toObject();
+            const QString name = result["scenario"].toString();
+            const QJsonObject expected = scenarios[name].toObject();
+
+            if (result["outcome"].toString() == "crashed")
+            {
+                out << "FAIL " << name << ": scenario crashed\n";
+                regressions++;
+                continue;
+            }
+
+            for (auto it = tolerance.constBegin(); it != tolerance.constEnd(); ++it)
+            {
+                const QString metric = it.key();
+                double measured = result[metric].toDouble();
+                if (!expected.contains(metric) || expected[metric].isNull())
+                {
+                    out << (allowMissing ? "skip " : "FAIL ") << name << " " << metric << " = " << measured
+                        << " (no baseline)\n";
+                    if (!allowMissing)
+                        regressions++;
+                    continue;
+                }
+
+                double reference = expected[metric].toDouble();
+                double allowed = it.value().toDouble();
+                bool regressed = isHigherBetter(metric) ? measured < reference * (1.0 - allowed)
+                                                        : measured > reference * (1.0 + allowed);
+                out << (regressed ? "FAIL " : "ok   ") << name << " " << metric << " = " << measured
+                    << " (baseline " << reference << ", tolerance " << allowed * 100.0 << "%)\n";
+                if (regressed)
+                    regressions++;
+            }
+        }
+        return regressions;
+    }
+
+    QJsonObject readJson(const QString &path)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+            return QJsonObject();
+        return QJsonDocument::fromJson(file.readAll()).object();
+    }
+
+    bool writeJson(const QString &path, const QJsonObject &object)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            return false;
+        file.write(QJsonDocument(object).toJson(QJsonDocument::Indented));
+        return true;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // 无界面运行：贴图与场景仍需 GUI 平台插件
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Replays canned game scenarios and checks them against a performance baseline.");
+    parser.addHelpOption();
+    QCommandLineOption scenarioOption("scenario", "Run a single scenario in-process and print its JSON result.", "name");
+    QCommandLineOption baselineOption("baseline", "Baseline file to compare against.", "path", BENCH_BASELINE_PATH);
+    QCommandLineOption updateOption("update-baseline", "Write the measured metrics into the baseline file.");
+    QCommandLineOption outputOption("output", "Also write the measured results to this JSON file.", "path");
+    QCommandLineOption allowMissingOption("allow-missing-baseline", "Report metrics without a baseline value instead of failing on them.");
+    parser.addOption(scenarioOption);
+    parser.addOption(baselineOption);
+    parser.addOption(updateOption);
+    parser.addOption(outputOption);
+    parser.addOption(allowMissingOption);
+    parser.process(app);
+
+    ResourceManager::instance().setSoundEnabled(false);
+
+    // 子进程模式：只跑一个场景，结果以单行 JSON 输出
+    if (parser.isSet(scenarioOption))
+    {
+        const Scenario *scenario = findScenario(parser.value(scenarioOption));
+        if (!scenario)
+        {
+            qWarning() << "Unknown scenario" << parser.value(scenarioOption);
+            return 2;
+        }
+        QJsonObject result = runScenario(*scenario);
+        out << QJsonDocument(result).toJson(QJsonDocument::Compact) << "\n";
+        out.flush();
+        if (parser.isSet(outputOption))
+            writeJson(parser.value(outputOption), result);
+        return 0;
+    }
+
+    QJsonArray results;
+    for (const Scenario &scenario : SCENARIOS)
+    {
+        QJsonObject result = runScenarioInChild(scenario);
+        out << QString("%1 %2 ticks=%3 ticks/s=%4 p50=%5us p99=%6us peakRss=%7KB allocs=%8\n")
+                   .arg(QString::fromLatin1(scenario.name), -16)
+                   .arg(result["outcome"].toString(), -9)
+                   .arg(result["ticks"].toInt())
+                   .arg(result["ticksPerSecond"].toDouble(), 0, 'f', 1)
+                   .arg(result["p50TickUs"].toDouble(), 0, 'f', 1)
+                   .arg(result["p99TickUs"].toDouble(), 0, 'f', 1)
+                   .arg(qint64(result["peakRssKb"].toDouble()))
+                   .arg(qint64(result["allocations"].toDouble()));
+        results.append(result);
+    }
+
+    if (parser.isSet(outputOption))
+    {
+        QJsonObject report;
+        report["results"] = results;
+        writeJson(parser.value(outputOption), report);
+    }
+
+    const QString baselinePath = parser.value(baselineOption);
+    QJsonObject baseline = readJson(baselinePath);
+
+    if (parser.isSet(updateOption))
+    {
+        QJsonObject scenarios = baseline["scenarios"].toObject();
+        const QJsonObject tolerance = baseline["tolerance"].toObject();
+        for (const QJsonValue &value : results)
+        {
+            const QJsonObject result = value.toObject();
+            QJsonObject recorded;
+            for (auto it = tolerance.constBegin(); it != tolerance.constEnd(); ++it)
+                recorded[it.key()] = result[it.key()];
+            scenarios[result["scenario"].toString()] = recorded;
+        }
+        baseline["scenarios"] = scenarios;
+        if (!writeJson(baselinePath, baseline))
+        {
+            qWarning() << "Failed to write baseline" << baselinePath;
+            return 2;
+        }
+        out << "Baseline updated: " << baselinePath << "\n";
+        return 0;
+    }
+
+    if (baseline.isEmpty())
+    {
+        qWarning() << "Baseline not found:" << baselinePath;
+        return 2;
+    }
+
+    int regressions = compareWithBaseline(results, baseline, parser.isSet(allowMissingOption), out);
+    out << (regressions == 0 ? "PASS" : "REGRESSION") << " (" << regressions << " failing metric(s))\n";
+    return regressions == 0 ? 0 : 1;
+}
@@ -0,0 +1,19 @@
+# Headless scenario benchmark: replays canned levels through GameManager and
+# compares ticks/s, tick latency, peak RSS and allocations against baseline.json.
+#
+#   ./bench_scenarios                      run all scenarios, fail on regression
+#   ./bench_scenarios --update-baseline    re-record baseline.json on this machine
+#   ./bench_scenarios --allow-missing-baseline   report metrics with no baseline instead of failing
+#   ./bench_scenarios --scenario stress_10k --output result.json
+
+include(../bench.pri)
+
+TARGET = bench_scenarios
+
+DEFINES += BENCH_BASELINE_PATH=\\\"$$PWD/baseline.json\\\"
+
+SOURCES += \
+    bench_scenarios.cpp
+
+DISTFILES += \
+    baseline.json
@@ -0,0 +1,128 @@
+#ifndef AUDIOMIXER_H
+#define AUDIOMIXER_H
+
+#include "config.h"
+#include "spscqueue.h"
+#include <QIODevice>
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <QElapsedTimer>
+#include <atomic>
+
+class QThread;
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+class QAudioSink;
+#else
+class QAudioOutput;
+#endif
+
+// 软件混音器：预解码 PCM，固定音轨数，单一输出流
+// - 游戏线程只把播放命令写入无锁队列，音频设备与混音都在独立线程
+// - play/stopAll 只允许单一线程（GUI 线程）调用
+class AudioMixer : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    // 创建混音器，不立即打开音频设备
+    explicit AudioMixer(QObject *parent = nullptr);
+    // 停止输出并释放音频设备
+    ~AudioMixer();
+
+    // 解码 WAV 并注册为可播放音效，只能在 start 之前调用
+    bool loadClip(const QString &soundId, const QString &filePath, int priority, int minIntervalMs);
+    // 注册已解码的 PCM 样本，只能在 start 之前调用
+    bool addClip(const QString &soundId, const QVector<qint16> &samples, int priority, int minIntervalMs);
+    // 读取并解码 WAV 文件（线程安全，可在工作线程调用）
+    static bool decodeWavFile(const QString &filePath, QVector<qint16> *samples);
+    // 启动音频线程并在其中打开音频设备
+    void start();
+    // 停止音频输出并结束音频线程
+    void stop();
+    // 投递播放命令，被限频或队列已满时返回 false
+    bool play(const QString &soundId, qreal volume = 1.0, bool loop = false);
+    // 投递停止所有音轨命令
+    void stopAll();
+
+    // 获取最近一次混音时发声的音轨数
+    int activeVoiceCount() const { return activeVoices.load(std::memory_order_relaxed); }
+    // 获取因队列已满被丢弃的命令数
+    int droppedCommandCount() const { return droppedCommands.load(std::memory_order_relaxed); }
+
+    // 顺序设备，总是可读
+    bool isSequential() const override { return true; }
+    // 返回可读字节数，保证输出端持续拉取
+    qint64 bytesAvailable() const override;
+
+protected:
+    // 混合所有活动音轨写入输出缓冲
+    qint64 readData(char *data, qint64 maxlen) override;
+    // 混音器不接受写入
+    qint64 writeData(const char *data, qint64 len) override;
+
+private:
+    // 解码后的单个音效
+    struct Clip
+    {
+        QVector<qint16> samples; // 单声道 16 位 PCM
+        int priority;
+        int minIntervalMs;
+        qint64 lastPlayedMs;
+    };
+
+    // 游戏线程投递给音频线程的命令
+    struct Command
+    {
+        enum Type
+        {
+            COMMAND_PLAY,
+            COMMAND_STOP_ALL
+        };
+
+        Type type;
+        const Clip *clip;
+        int gain;
+        bool loop;
+    };
+
+    // 正在播放的音轨（仅音频线程访问）
+    struct Voice
+    {
+        const Clip *clip;
+        int position;
+        int gain;      // 定点音量，256 表示原始音量，合并音效最高 512
+        int priority;
+        bool loop;
+        bool active;
+    };
+
+    // 解析 WAV 文件为单声道 PCM 样本
+    static bool decodeWav(const QByteArray &bytes, QVector<qint16> *samples);
+    // 选择空闲音轨或可抢占的音轨，找不到时返回 -1
+    int pickVoice(int priority) const;
+    // 在音频线程执行排队的命令
+    void drainCommands();
+    // 将活动音轨混入输出样本
+    void mixInto(qint16 *out, int frames);
+
+    QHash<QString, Clip *> clips; // start 之后只读，音频线程可安全持有指针
+    Voice voices[GameConfig::AUDIO_MAX_VOICES];
+    QVector<qint32> mixBuffer;
+    SpscQueue<Command, 256> commands;
+    std::atomic<int> activeVoices;
+    std::atomic<int> droppedCommands;
+    QElapsedTimer clock;
+
+    QThread *audioThread;
+    QObject *outputContext; // 驻留在音频线程，用于在该线程创建与销毁输出设备
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    QAudioSink *sink;
+#else
+    QAudioOutput *sink;
+#endif
+};
+
+#endif // AUDIOMIXER_H
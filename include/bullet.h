@@ -4,8 +4,10 @@
 #include "gameentity.h"
 #include "enemy.h"
 #include "config.h"
-#include <QTimer>
 #include <QPointer>
+#include <QHash>
+
+class QDataStream;
 
 // 投射物子弹实体
 class Bullet : public GameEntity, public ISoundPlayable
@@ -27,13 +29,48 @@ public:
 
     // 刷新子弹位置与命中
     void update() override;
+    // 按模拟时间推进移动节拍
+    void advance(int dtMs);
+    // 累加模拟时间并取出本帧应走的步数，暂停或已结束时为 0
+    int takeMoveSteps(int dtMs);
+    // 无目标时累计丢失时长，超时后结束子弹并返回 true
+    bool expireLostTarget();
+    // 命中当前目标：结算伤害并结束子弹
+    void hitTarget();
+    // 命中途经的某个敌人（不一定是目标）：结算伤害并结束子弹
+    void hitEnemy(Enemy *enemy);
+    // 落实一步移动后的位置与方向，不再追踪时放弃目标，飞出射程或地图时结束
+    void applyStep(const QPointF &nextPos, const QPointF &newDirection, bool tracking);
+    // 目标沿固定路线时按预测找出第一帧能够着目标的时刻，改走解析弹道；目标不可预测或够不着时返回 false
+    bool planIntercept(int tickMs);
+    // 解析弹道：累加飞行时间，到点直接结算命中，途中只插值显示位置；目标提前消失时转回逐步模拟
+    void advanceFlight(int dtMs);
+    // 是否按解析弹道飞行
+    bool isAnalytic() const { return analytic; }
+    // 子弹已命中或失效等待销毁
+    bool isFinished() const { return finished; }
     // 获取当前追踪目标
     Enemy* getTarget() const { return target; }
+    // 获取单位飞行方向
+    QPointF getDirection() const { return direction; }
+    // 获取每步飞行距离
+    float getSpeed() const { return speed; }
+    // 获取场上存活子弹数量
+    static int getLiveCount() { return liveCount; }
+    // 按最大转角向目标方向修正，目标偏离超过 90 度时返回 false
+    static bool steerTowards(const QPointF &currentDir, const QPointF &toTarget, qreal maxTurnRad, QPointF *newDir);
+    // 从 from 移到 to 的途中与圆首次接触的时刻 t ∈ [0, 1]，起点已在圆内时为 0，途中不接触返回 false
+    static bool sweepCircle(const QPointF &from, const QPointF &to, const QPointF &center, qreal radius, qreal *time);
     
-    // 暂停子弹移动计时器
-    void pauseMovement() { if (moveTimer) moveTimer->stop(); }
-    // 恢复子弹移动计时器
-    void resumeMovement() { if (moveTimer && !moveTimer->isActive()) moveTimer->start(GameConfig::BULLET_MOVE_INTERVAL); }
+    // 写入存档所需的运行状态，目标敌人以下标保存
+    void saveState(QDataStream &out, const QHash<const Enemy *, int> &enemyIndex) const;
+    // 按存档重建子弹，目标下标对应 enemies 列表
+    static Bullet *restoreState(QDataStream &in, const QList<QPointer<Enemy>> &enemies, QObject *parent = nullptr);
+
+    // 暂停子弹移动节拍
+    void pauseMovement() { movementPaused = true; }
+    // 恢复子弹移动节拍
+    void resumeMovement() { movementPaused = false; }
 
     // 注入资源管理器用于音效
     void setResourceManager(ResourceManager *manager) override { resourceManager = manager; }
@@ -47,22 +84,30 @@ signals:
 private:
     // 根据方向更新朝向角度
     void updateRotation();
-
-private slots:
-    // 子弹移动计时器回调
-    void onMoveTimer();
+    // 移动一步并检测命中；单独推进时没有宽相位索引，只与目标做扫掠检测
+    void step();
+    // 移出场景并延迟销毁
+    void finish();
 
 private:
     BulletType bulletType; // 子弹类型
     QPointer<Enemy> target;  // 使用QPointer自动跟踪target的生命周期
     int damage; // 伤害
     float speed; // 速度
-    QTimer* moveTimer;
+    int moveAccumulatorMs;
+    bool movementPaused;
+    bool finished;
     QPointF direction; // 方向
     QPointF startPosition; // 发射位置
     float travelledDistance;
     int lostTargetTimeMs;
+    bool analytic;
+    QPointF launchPosition; // 解析弹道的起点
+    int flightMs; // 解析弹道从发射到命中的模拟时长
+    int flightElapsedMs;
     ResourceManager *resourceManager;
+
+    static int liveCount;
 };
 
 #endif
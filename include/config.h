@@ -2,6 +2,7 @@
 #define CONFIG_H
 
 #include <QHash>
+#include <QSet>
 #include <QVector>
 #include <QPointF>
 
@@ -180,6 +181,34 @@ namespace GameConfig
     // 失去目标后维持追踪的最大时间（毫秒）
     const int BULLET_TARGET_LOST_TIMEOUT_MS = 400;
 
+    // 子弹追踪时单步最大转向角度（度）
+    const float BULLET_MAX_TURN_DEG = 15.0f;
+
+    // 目标沿固定路线时，开火即算出命中帧并按解析弹道飞行，不再逐步追踪
+    const bool BULLET_ANALYTIC_IMPACT = true;
+
+    // ======================== 音频混音配置 ========================
+
+    // 混音输出采样率（Hz），与资源中 WAV 文件一致
+    const int AUDIO_SAMPLE_RATE = 44100;
+
+    // 同时发声的最大音轨数，超出时按优先级抢占
+    const int AUDIO_MAX_VOICES = 12;
+
+    // 音频输出缓冲时长（毫秒）
+    const int AUDIO_BUFFER_MS = 40;
+
+    // 同帧合并音效时，数量每翻一倍增加的音量比例
+    const float SOUND_BATCH_VOLUME_STEP = 0.25f;
+
+    // 合并后音效的最大音量（1.0 为原始音量）
+    const float SOUND_BATCH_MAX_VOLUME = 1.6f;
+
+    // ======================== 启动性能配置 ========================
+
+    // 进程启动到主菜单首帧绘制的预算（毫秒），超出时告警，--startup-check 下以非零码退出
+    const int STARTUP_FIRST_PAINT_BUDGET_MS = 600;
+
     // ======================== 地图与路径配置 ========================
 
     // 终点区域配置，用于判断敌人是否到达萝卜
@@ -194,9 +223,13 @@ namespace GameConfig
     enum MapId
     {
         MAP1 = 0,
-        MAP2 = 1
+        MAP2 = 1,
+        MAP3 = 2
     };
 
+    // 关卡总数，地图序号范围为 [0, MAP_COUNT)
+    const int MAP_COUNT = 3;
+
     // 网格坐标结构，统一描述路径点与建塔点位置
     struct GridPoint
     {
@@ -238,11 +271,28 @@ namespace GameConfig
             {18, 8},
         };
 
-        // 根据地图 ID 查找对应路径配置的映射表
-        const QHash<MapId, QVector<GridPoint>> PATH_MAP = {
-            {MAP1, MAP1_PATH},
-            {MAP2, MAP2_PATH},
+        // 地图 3 为开阔地图：两条出兵路线各自只给出生点与终点，中间路线由流场决定
+        const QVector<GridPoint> MAP3_LANE_NORTH = {
+            {0, 6},
+            {19, 8},
+        };
+        const QVector<GridPoint> MAP3_LANE_SOUTH = {
+            {0, 13},
+            {19, 11},
+        };
+
+        // 每张地图的全部出兵路线：首点为出生点，末点为终点，敌人按生成顺序轮流分配
+        const QHash<MapId, QVector<QVector<GridPoint>>> LANE_MAP = {
+            {MAP1, {MAP1_PATH}},
+            {MAP2, {MAP2_PATH}},
+            {MAP3, {MAP3_LANE_NORTH, MAP3_LANE_SOUTH}},
         };
+
+        // 开阔地图：塔可放在场地任意格，敌人绕塔寻路
+        const QSet<MapId> OPEN_FIELD_MAPS = {MAP3};
+
+        // 开阔地图可用场地的首行，上方留给控制面板
+        const int OPEN_FIELD_TOP_ROW = 5;
     }
 
     // ======================== 建塔可放置区域配置 ========================
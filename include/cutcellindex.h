@@ -0,0 +1,45 @@
+#ifndef CUTCELLINDEX_H
+#define CUTCELLINDEX_H
+
+#include <QPoint>
+#include <QVector>
+
+class FlowField;
+
+// 可通行格子图上的割点索引：回答“堵住某格后，某格还能否走到终点”
+class CutCellIndex
+{
+public:
+    // 构造空索引
+    CutCellIndex();
+
+    // 以连着所有终点格的虚拟根对可通行格做一次深度优先遍历，记录子树区间与 low 值
+    void rebuild(const FlowField &field, const QVector<QPoint> &goalCells);
+    // 索引是否已建立
+    bool isValid() const { return !enter.isEmpty(); }
+    // 堵住 blockCell 后，cell 是否会与所有终点断开；cell 本身已不可达时返回 false
+    bool separates(const QPoint &blockCell, const QPoint &cell) const;
+
+private:
+    // 格子坐标是否在索引内
+    bool contains(const QPoint &cell) const
+    {
+        return cell.x() >= 0 && cell.y() >= 0 && cell.x() < cols && cell.y() < rowCount;
+    }
+    // 格子在一维数组中的下标
+    int index(const QPoint &cell) const { return cell.y() * cols + cell.x(); }
+
+    int cols;
+    int rowCount;
+    // 虚拟根的下标，排在所有格子之后
+    int root;
+    // 进入序号，未访问为 -1
+    QVector<int> enter;
+    // 子树最后一个格子的进入序号
+    QVector<int> leave;
+    // 子树经回边能到达的最小进入序号
+    QVector<int> low;
+    QVector<int> parent;
+};
+
+#endif // CUTCELLINDEX_H
@@ -4,10 +4,14 @@
 #include "gameentity.h"
 #include "resourcemanager.h"
 #include "config.h"
-#include <QTimer>
+#include "lanepath.h"
 #include <QVector>
+#include <QSharedPointer>
 #include <QElapsedTimer>
 
+class QDataStream;
+class FlowField;
+
 // 敌人单位图元实体
 class Enemy : public GameEntity
 {
@@ -23,10 +27,32 @@ public:
 
     // 刷新敌人逻辑与移动
     void update() override;
-    // 设置敌人路径点序列
-    void setPath(const QVector<QPointF>& pathPoints);
+    // 设置敌人所走的共享路线并回到起点
+    void setPath(const QSharedPointer<const LanePath> &lanePath);
+    // 获取沿路线已走过的弧长
+    float getProgress() const { return progress; }
+    // 设置沿路线的弧长并更新位置，走到尽头时标记抵达终点
+    void setProgress(float newProgress);
+    // 获取所走路线的总长
+    float getPathLength() const { return path ? static_cast<float>(path->totalLength()) : 0.0f; }
+    // 是否沿固定路线行进（未使用流场）
+    bool isOnLanePath() const { return !flowField && path && !path->isEmpty(); }
+    // 按固定帧长预测 ticks 帧之后沿路线的弧长（不超过路线总长），与每帧推进 (节拍步数 + 1) 步的规则一致
+    float predictProgress(int ticks, int tickMs) const;
+    // 预测 ticks 帧之后的中心坐标，仅对沿固定路线的敌人有意义
+    QPointF predictCenter(int ticks, int tickMs) const;
     // 沿当前路径移动一帧
     void moveAlongPath();
+    // 设置敌人所走的出兵路线编号
+    void setLane(int laneIndex) { lane = laneIndex; }
+    // 获取敌人所走的出兵路线编号
+    int getLane() const { return lane; }
+    // 设置共享流场，设置后不再沿固定路径而是按流场寻路
+    void setFlowField(const FlowField *field) { flowField = field; }
+    // 按模拟时间推进移动节拍
+    void advance(int dtMs);
+    // 累加模拟时间并取出本帧应走的步数，暂停时为 0
+    int takeMoveSteps(int dtMs);
 
     // 获取被击杀奖励金币
     int getReward() const { return reward; }
@@ -45,10 +71,15 @@ public:
     // 设置当前移动速度
     void setSpeed(float newSpeed) { speed = newSpeed; }
     
-    // 暂停敌人移动计时器
-    void pauseMovement() { if (moveTimer) moveTimer->stop(); }
-    // 恢复敌人移动计时器
-    void resumeMovement() { if (moveTimer && currentState != ResourceManager::ENEMY_DEAD) moveTimer->start(GameConfig::ENEMY_MOVE_INTERVAL); }
+    // 暂停敌人移动节拍
+    void pauseMovement() { movementPaused = true; }
+    // 恢复敌人移动节拍
+    void resumeMovement() { if (currentState != ResourceManager::ENEMY_DEAD) movementPaused = false; }
+
+    // 写入存档所需的全部运行状态
+    void saveState(QDataStream &out) const;
+    // 按存档重建敌人，按存档中的路线编号取当前地图的路径
+    static Enemy *restoreState(QDataStream &in, const QVector<QSharedPointer<const LanePath>> &lanePaths, QObject *parent = nullptr);
 
     // 设置高亮显示状态
     void setHighlighted(bool highlighted) { isHighlighted = highlighted; }
@@ -56,14 +87,13 @@ public:
     bool getHighlighted() const { return isHighlighted; }
 
 protected:
+    // 按流场朝相邻的更近格子移动一帧
+    void moveAlongFlowField();
     // 自定义绘制包含高亮效果
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
     // 返回扩展后的包围矩形
     QRectF boundingRect() const override;
 
-private slots:
-    // 敌人移动计时器回调
-    void onMoveTimer();
 signals:
     // 敌人到达终点信号
     void reachedEndPoint();
@@ -74,9 +104,13 @@ private:
     int reward;
     float speed;
     EnemyState currentState;
-    QVector<QPointF> pathPoints;
-    int currentPathIndex;
-    QTimer *moveTimer;
+    QSharedPointer<const LanePath> path;
+    // 沿路线走过的弧长，位置由它在路线上查段得出
+    float progress;
+    const FlowField *flowField;
+    int lane;
+    int moveAccumulatorMs;
+    bool movementPaused;
     bool reachedEnd;
     bool isHighlighted;
 };
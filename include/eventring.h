@@ -0,0 +1,83 @@
+#ifndef EVENTRING_H
+#define EVENTRING_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <atomic>
+
+// 定长无锁环形事件缓冲区
+// - 多个线程可并发写入，写满后覆盖最旧的记录
+// - 每个槽位带序号，读取方据此丢弃正在被覆盖的记录
+template <typename T, int Capacity>
+class EventRing
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "EventRing capacity must be a power of two");
+
+public:
+    EventRing()
+        : writeCursor(0)
+    {
+        for (int i = 0; i < Capacity; ++i)
+            slots[i].sequence.store(0, std::memory_order_relaxed);
+    }
+
+    // 写入一条记录（无锁，满时覆盖）
+    void push(const T &value)
+    {
+        quint64 ticket = writeCursor.fetch_add(1, std::memory_order_relaxed);
+        Slot &slot = slots[ticket & (Capacity - 1)];
+        slot.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.value = value;
+        slot.sequence.store(ticket + 1, std::memory_order_release);
+    }
+
+    // 复制序号不小于 fromTicket 且仍有效的记录（按写入顺序），返回下一次读取的起点
+    quint64 snapshot(QVector<T> &out, quint64 fromTicket = 0) const
+    {
+        quint64 end = writeCursor.load(std::memory_order_acquire);
+        quint64 begin = end > static_cast<quint64>(Capacity) ? end - Capacity : 0;
+        if (begin < fromTicket)
+            begin = fromTicket;
+        if (begin >= end)
+            return end;
+        out.reserve(out.size() + static_cast<int>(end - begin));
+
+        for (quint64 ticket = begin; ticket < end; ++ticket)
+        {
+            const Slot &slot = slots[ticket & (Capacity - 1)];
+            quint64 before = slot.sequence.load(std::memory_order_acquire);
+            if (before != ticket + 1)
+                continue;
+            T copy = slot.value;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == before)
+                out.append(copy);
+        }
+        return end;
+    }
+
+    // 获取累计写入的记录数
+    quint64 totalWritten() const { return writeCursor.load(std::memory_order_relaxed); }
+
+    // 丢弃全部记录（仅在无并发写入时调用）
+    void clear()
+    {
+        for (int i = 0; i < Capacity; ++i)
+            slots[i].sequence.store(0, std::memory_order_relaxed);
+        writeCursor.store(0, std::memory_order_release);
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<quint64> sequence;
+        T value;
+    };
+
+    Slot slots[Capacity];
+    std::atomic<quint64> writeCursor;
+};
+
+#endif // EVENTRING_H
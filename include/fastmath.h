@@ -0,0 +1,110 @@
+#ifndef FASTMATH_H
+#define FASTMATH_H
+
+#include <QtGlobal>
+#include <cstring>
+
+// 实体朝向与转向用的近似数学函数，误差上限见各函数说明（在基准程序中对照 <cmath> 校验）
+namespace FastMath
+{
+    const float PI = 3.14159265358979323846f;
+    const float TWO_PI = 6.28318530717958647692f;
+    const float HALF_PI = 1.57079632679489661923f;
+    const float RAD_TO_DEG = 57.2957795130823208768f;
+    const float DEG_TO_RAD = 0.01745329251994329577f;
+
+    // 弧度折回 [-π, π]，|angle| ≤ 1e4 时与精确取余相差不超过 1.0e-6
+    inline float wrapRadians(float angle)
+    {
+        // 2π 拆成两段，整圈数乘第一段时没有舍入
+        const float turns = static_cast<float>(qRound(angle * (1.0f / TWO_PI)));
+        float wrapped = (angle - turns * 6.28125f) - turns * 1.93530717958647692e-3f;
+        // 圈数估算在 ±π 附近可能差一圈
+        if (wrapped > PI)
+            wrapped -= TWO_PI;
+        else if (wrapped < -PI)
+            wrapped += TWO_PI;
+        return wrapped;
+    }
+
+    // 角度折回 [-180, 180]，输入须为有限值
+    inline qreal wrapDegrees(qreal angle)
+    {
+        return angle - 360.0 * qRound(angle / 360.0);
+    }
+
+    // 多项式 atan2，最大绝对误差 1.2e-5 弧度；(0, 0) 返回 0
+    inline float atan2(float y, float x)
+    {
+        const float absX = x < 0.0f ? -x : x;
+        const float absY = y < 0.0f ? -y : y;
+        const float maxAbs = absX > absY ? absX : absY;
+        if (maxAbs == 0.0f)
+            return 0.0f;
+
+        // 先求 [0, 1] 上的 atan，再按象限展开
+        const float ratio = (absX < absY ? absX : absY) / maxAbs;
+        const float s = ratio * ratio;
+        float angle = ((((0.0208351f * s - 0.0851330f) * s + 0.1801410f) * s - 0.3302995f) * s + 0.9998660f) * ratio;
+        if (absY > absX)
+            angle = HALF_PI - angle;
+        if (x < 0.0f)
+            angle = PI - angle;
+        return y < 0.0f ? -angle : angle;
+    }
+
+    // atan2 的角度版本，最大绝对误差 7.0e-4 度
+    inline float atan2Degrees(float y, float x)
+    {
+        return atan2(y, x) * RAD_TO_DEG;
+    }
+
+    // 同时求正弦与余弦，|angle| ≤ 1e4 时最大绝对误差 5.0e-7
+    inline void sincos(float angle, float *sinOut, float *cosOut)
+    {
+        // 按 π/2 分象限，π/2 拆成两段减少折算误差
+        const float quadrant = static_cast<float>(qRound(angle * (2.0f / PI)));
+        const float r = (angle - quadrant * 1.5703125f) - quadrant * 4.83826794897e-4f;
+        const float r2 = r * r;
+        const float s = r + r * r2 * (-1.66666546e-1f + r2 * (8.33216087e-3f + r2 * -1.95152959e-4f));
+        const float c = 1.0f + r2 * (-0.5f + r2 * (4.16666418e-2f + r2 * (-1.38873163e-3f + r2 * 2.44331571e-5f)));
+
+        // 象限序号取模 4，负数的补码低两位同样正确
+        switch (static_cast<int>(quadrant) & 3)
+        {
+        case 0:
+            *sinOut = s;
+            *cosOut = c;
+            break;
+        case 1:
+            *sinOut = c;
+            *cosOut = -s;
+            break;
+        case 2:
+            *sinOut = -s;
+            *cosOut = -c;
+            break;
+        default:
+            *sinOut = -c;
+            *cosOut = s;
+            break;
+        }
+    }
+
+    // 1/sqrt(x)，x > 0 时最大相对误差 5.0e-6
+    inline float rsqrt(float x)
+    {
+        quint32 bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        bits = 0x5f375a86u - (bits >> 1);
+        float y;
+        std::memcpy(&y, &bits, sizeof(y));
+        // 两次牛顿迭代
+        const float halfX = 0.5f * x;
+        y = y * (1.5f - halfX * y * y);
+        y = y * (1.5f - halfX * y * y);
+        return y;
+    }
+}
+
+#endif // FASTMATH_H
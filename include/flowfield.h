@@ -0,0 +1,72 @@
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+
+#include <QPoint>
+#include <QVector>
+
+class OccupancyGrid;
+
+// 开阔地图的共享流场：每格记录到最近终点的步数，所有敌人按它下坡行进
+class FlowField
+{
+public:
+    // 不可达格子的距离值
+    static const int UNREACHABLE = 0x3fffffff;
+
+    // 构造空流场
+    FlowField();
+
+    // 按占用网格与终点格整体重算一次
+    void reset(const OccupancyGrid &grid, const QVector<QPoint> &goalCells);
+    // 流场是否已初始化
+    bool isValid() const { return !dist.isEmpty(); }
+    // 流场列数
+    int columns() const { return cols; }
+    // 流场行数
+    int rows() const { return rowCount; }
+
+    // 格子到终点的步数，越界或不可达时为 UNREACHABLE
+    int distance(int cellX, int cellY) const
+    {
+        return contains(cellX, cellY) ? dist[index(cellX, cellY)] : UNREACHABLE;
+    }
+    // 格子是否可通行
+    bool isWalkable(int cellX, int cellY) const
+    {
+        return contains(cellX, cellY) && walkable[index(cellX, cellY)];
+    }
+    // 取下一步要走的相邻格，无路可走时返回 false
+    bool nextCell(int cellX, int cellY, int *nextX, int *nextY) const;
+
+    // 格子被塔挡住，只修正依赖它的那部分距离
+    void blockCell(int cellX, int cellY);
+    // 格子重新可通行，只向外传播变短的距离
+    void unblockCell(int cellX, int cellY);
+    // 上一次增量更新改动过的格子数
+    int lastUpdatedCells() const { return updatedCells; }
+
+private:
+    // 格子坐标是否在流场内
+    bool contains(int cellX, int cellY) const
+    {
+        return cellX >= 0 && cellY >= 0 && cellX < cols && cellY < rowCount;
+    }
+    // 格子在一维数组中的下标
+    int index(int cellX, int cellY) const { return cellY * cols + cellX; }
+    // 取四邻格下标，返回个数
+    int neighbours(int cell, int out[4]) const;
+    // 从可通行邻格推出的最短距离
+    int bestFromNeighbours(int cell) const;
+
+    int cols;
+    int rowCount;
+    QVector<int> dist;
+    QVector<quint8> walkable;
+    QVector<quint8> goal;
+    // 增量更新时标记受影响格子，用代数避免每次清零
+    QVector<quint32> mark;
+    quint32 markGeneration;
+    int updatedCells;
+};
+
+#endif // FLOWFIELD_H
@@ -0,0 +1,96 @@
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QVector>
+
+// 逐帧分阶段耗时与分配次数统计
+class FrameProfiler
+{
+public:
+    // 参与计时的帧阶段
+    enum Phase
+    {
+        PHASE_UPDATE_ENEMIES = 0,
+        PHASE_UPDATE_TOWERS,
+        PHASE_REMOVE_DEAD,
+        PHASE_CHECK_WAVE,
+        PHASE_BULLETS,
+        PHASE_PAINT,
+        PHASE_COUNT
+    };
+
+    // 滚动窗口内的统计结果（纳秒）
+    struct Stats
+    {
+        qint64 minNs;
+        qint64 avgNs;
+        qint64 p99Ns;
+    };
+
+    // 滚动窗口保留的帧数
+    static const int WINDOW_SIZE = 120;
+
+    // 获取全局单例分析器
+    static FrameProfiler &instance();
+
+    // 累加某阶段的耗时
+    void addPhaseTime(Phase phase, qint64 nsecs);
+    // 记录当前帧实体数量
+    void setEntityCounts(int enemies, int towers, int bullets);
+    // 记录最近一次选关到首个模拟帧的耗时（毫秒）
+    void setLevelStartMs(qint64 ms) { levelStartMs = ms; }
+    // 提交当前帧并写入滚动窗口
+    void endFrame();
+
+    // 获取阶段滚动统计
+    Stats phaseStats(Phase phase) const;
+    // 获取整帧耗时滚动统计
+    Stats frameStats() const;
+    // 获取每帧分配次数滚动统计
+    Stats allocationStats() const;
+    // 生成叠加层显示文本
+    QString overlayText() const;
+
+    // 获取阶段显示名称
+    static const char *phaseName(Phase phase);
+    // 获取进程累计堆分配次数，未启用分配计数时恒为 0
+    static quint64 allocationCount();
+    // 本构建是否替换了全局分配函数以统计分配次数
+    static bool countsAllocations();
+
+private:
+    // 私有构造仅供单例使用
+    FrameProfiler();
+
+    // 对环形样本计算统计值
+    Stats computeStats(const QVector<qint64> &ring) const;
+
+    qint64 pendingNs[PHASE_COUNT];
+    QVector<qint64> phaseSamples[PHASE_COUNT];
+    QVector<qint64> frameSamples;
+    QVector<qint64> allocationSamples;
+    int writeIndex;
+    int sampleCount;
+    quint64 lastAllocationCount;
+
+    int enemyCount;
+    int towerCount;
+    int bulletCount;
+    qint64 levelStartMs;
+};
+
+// 在作用域内为指定阶段计时
+class ScopedPhaseTimer
+{
+public:
+    explicit ScopedPhaseTimer(FrameProfiler::Phase phase);
+    ~ScopedPhaseTimer();
+
+private:
+    FrameProfiler::Phase phase;
+    QElapsedTimer timer;
+};
+
+#endif // FRAMEPROFILER_H
@@ -7,6 +7,11 @@
 #include "config.h"
 #include "gameentity.h"
 #include "resourcemanager.h"
+#include "occupancygrid.h"
+#include "flowfield.h"
+#include "cutcellindex.h"
+#include "targetingindex.h"
+#include "spatialindex.h"
 #include <QObject>
 #include <QList>
 #include <QPointer>
@@ -14,6 +19,10 @@
 #include <QVector>
 #include <QPointF>
 
+class QGraphicsScene;
+#include <QByteArray>
+#include "gamerandom.h"
+
 // 管理整体关卡与战斗状态
 class GameManager : public QObject, public ISoundPlayable
 {
@@ -23,9 +32,9 @@ public:
     // 构造游戏管理器实例
     explicit GameManager(QObject *parent = nullptr);
 
-    // 初始化地图路径与终点
+    // 初始化地图各条出兵路线与终点
     void initialize(GameConfig::MapId mapId,
-                    const QVector<QPointF> &pathPoints,
+                    const QVector<QSharedPointer<const LanePath>> &lanePaths,
                     const QVector<GameConfig::EndPointConfig> &endPoints);
 
     // 开始或继续游戏循环
@@ -34,9 +43,35 @@ public:
     void pauseGame();
     // 重置关卡与统计数据
     void resetGame();
+    // 记录当前状态为关卡初始快照
+    void captureSnapshot();
+    // 从关卡初始快照还原，只广播发生变化的数值
+    void restoreSnapshot();
+
+    // 序列化完整对局状态（敌人、塔、子弹、波次、金币、生命与随机数）
+    QByteArray saveState() const;
+    // 从存档恢复对局，实体经由与正常生成相同的信号加入场景
+    bool loadState(const QByteArray &data, QGraphicsScene *scene, QObject *parentForTowers);
+    // 只读取存档头部的地图与波次，用于提示继续游戏
+    static bool peekSave(const QByteArray &data, GameConfig::MapId *mapId, int *wave);
+    // 按给定模拟时间推进一帧
+    void stepSimulation(int dtMs);
+
+    // 按地图配置生成每条出兵路线，供该路线上的敌人共享
+    static QVector<QSharedPointer<const LanePath>> buildLanePaths(GameConfig::MapId mapId);
+    // 按地图配置生成终点区域，多条路线共用的终点只出现一次
+    static QVector<GameConfig::EndPointConfig> buildEndPoints(GameConfig::MapId mapId);
 
     // 获取当前金币数量
     int getGold() const { return gold; }
+    // 直接设置金币数量
+    void setGold(int newGold);
+    // 直接设置剩余生命
+    void setLives(int newLives);
+    // 覆盖每波敌人数与刷怪间隔，传 0 恢复默认
+    void setWaveOverride(int enemyCount, int spawnIntervalMs);
+    // 设置随机敌人类型的种子
+    void setRandomSeed(quint32 seed) { enemyTypeRandom.seed(seed); }
     // 获取剩余生命数量
     int getLives() const { return lives; }
     // 获取当前波次编号
@@ -54,6 +89,14 @@ public:
     const QList<QPointer<Tower>> &getTowers() const { return towers; }
     // 获取当前所有子弹列表
     const QList<QPointer<Bullet>> &getBullets() const { return bullets; }
+    // 获取地图格子占用情况
+    const OccupancyGrid &getOccupancy() const { return occupancy; }
+    // 当前地图是否为开阔地图
+    bool isOpenField() const { return openField; }
+    // 获取开阔地图的共享流场
+    const FlowField &getFlowField() const { return flowField; }
+    // 开阔地图上在该格建塔是否会让出生点或场上敌人走不到终点
+    bool wouldBlockPath(int cellX, int cellY) const;
 
     // 建造指定类型防御塔
     QPointer<Tower> buildTower(Tower::TowerType type, const QPointF &position, QObject *parentForTower);
@@ -69,6 +112,7 @@ signals:
     void killCountChanged(int killCount);
     void gameStateChanged(bool running, bool paused);
     void gameOver();
+    void firstTickSimulated();
     void levelCompleted(GameConfig::MapId mapId, int wave);
 
     void enemySpawnRequested(QPointer<Enemy> enemy);
@@ -79,9 +123,9 @@ signals:
     void towerDemolished(QPointer<Tower> tower);
 
 public slots:
-    // 定时生成下一只敌人
+    // 生成下一只敌人
     void spawnEnemy();
-    // 驱动一帧游戏更新
+    // 游戏计时器驱动一帧更新
     void updateGame();
 
     // 注入资源管理器用于音效
@@ -90,18 +134,34 @@ public slots:
     void playSound(const QString &soundId, qreal volume = 1.0, bool loop = false) override;
 
 private:
+    // 累加刷怪节拍并生成敌人
+    void updateSpawner(int dtMs);
     // 更新所有敌人列表状态
-    void updateEnemies();
+    void updateEnemies(int dtMs);
     // 更新所有防御塔状态
-    void updateTowers();
+    void updateTowers(int dtMs);
+    // 推进所有在飞子弹
+    void updateBullets(int dtMs);
+    // 整批推进 bullets 中 [first, last) 的子弹
+    void stepBullets(int first, int last, int dtMs);
+    // 线段 from→to 途中最先碰到的敌人，没有时返回 nullptr
+    Enemy *findSweptHit(const QPointF &from, const QPointF &to, qreal radius);
+    // 接管塔发射的子弹
+    void trackTowerBullets(QPointer<Tower> tower);
     // 清理已死亡实体对象
     void removeDeadEntities();
     // 检查并触发下一波敌人
     void checkNextWave();
     // 计算当前波次刷怪间隔
     int getWaveSpawnInterval() const;
-    // 判断敌人是否到任一终点
-    bool isEnemyAtAnyEndPoint(QPointer<Enemy> enemy) const;
+    // 获取每波敌人总数
+    int getWaveEnemyCount() const;
+    // 判断敌人是否已抵达终点
+    bool hasReachedEnd(QPointer<Enemy> enemy) const;
+    // 按当前占用网格整体重算流场
+    void rebuildFlowField();
+    // 开阔地图上一格被占用或腾出后，增量修正流场并重建割点索引
+    void updateOpenFieldCell(int cellX, int cellY, bool blocked);
 
     // 根据类型计算塔造价
     int getTowerCost(Tower::TowerType type) const;
@@ -122,14 +182,83 @@ private:
     bool waveSpawnComplete;
     bool gameRunning;
     bool paused;
+    // startGame 之后尚未跑完第一帧
+    bool firstTickPending;
     int killCount;
 
+    // 关卡开局时的全部可变状态，重开时整体拷回
+    struct LevelSnapshot
+    {
+        int gold;
+        int lives;
+        int currentWave;
+        int enemiesSpawnedThisWave;
+        bool waveSpawnComplete;
+        int killCount;
+        int spawnAccumulatorMs;
+        GameRandom enemyTypeRandom;
+    };
+    LevelSnapshot snapshot;
+    bool snapshotValid;
+
+    // 沿固定路线的敌人整批推进时复用的连续数组
+    struct EnemyBatch
+    {
+        QVector<Enemy *> items;
+        QVector<float> progress;
+        QVector<float> speed;
+        QVector<float> steps;
+        QVector<float> length;
+    };
+    EnemyBatch enemyBatch;
+
+    // 子弹整批推进时复用的连续数组
+    struct BulletBatch
+    {
+        QVector<Bullet *> items;
+        QVector<int> steps;
+        QVector<float> x;
+        QVector<float> y;
+        QVector<float> dirX;
+        QVector<float> dirY;
+        QVector<float> targetX;
+        QVector<float> targetY;
+        QVector<float> speed;
+        QVector<qint32> tracking;
+        QVector<qint32> hit;
+    };
+    BulletBatch bulletBatch;
+    // 子弹扫掠检测的宽相位：本帧敌人中心，每帧推进子弹前重建
+    SpatialIndex<Enemy *> bulletColliders;
+    QVector<Enemy *> sweepCandidates;
+
+    // 塔索敌时复用的敌人坐标与查询结果
+    struct TargetingScratch
+    {
+        QVector<Enemy *> items;
+        QVector<float> x;
+        QVector<float> y;
+        QVector<int> hits;
+    };
+    TargetingScratch targetingScratch;
+    TargetingIndex targeting;
+
     GameConfig::MapId currentMapId;
-    QVector<QPointF> pathPoints;
+    QVector<QSharedPointer<const LanePath>> lanePaths;
     QVector<GameConfig::EndPointConfig> endPointAreas;
+    OccupancyGrid occupancy;
+    bool openField;
+    FlowField flowField;
+    CutCellIndex cutCells;
+    QVector<QPoint> spawnCells;
+    QVector<QPoint> goalCells;
+
+    int spawnAccumulatorMs;
+    int waveEnemyCountOverride;
+    int spawnIntervalOverrideMs;
+    GameRandom enemyTypeRandom;
 
     QTimer *gameTimer;
-    QTimer *enemySpawnTimer;
     ResourceManager *resourceManager;
 };
 
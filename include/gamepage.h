@@ -20,7 +20,6 @@ class QPushButton;
 class QVBoxLayout;
 class QHBoxLayout;
 class QGraphicsRectItem;
-class PlacementValidator;
 class QGraphicsOpacityEffect;
 
 namespace Ui
@@ -47,6 +46,10 @@ public:
     void resetGame();
     // 切换当前关卡地图
     void setMap(GameConfig::MapId mapId);
+    // 从开局快照重开当前关卡
+    void restartLevel();
+    // 从存档数据继续对局，失败时返回 false
+    bool resumeSavedGame(const QByteArray &data);
 
 signals:
     // 游戏结束返回结果信号
@@ -65,8 +68,6 @@ private:
     void initGameScene();
     // 初始化界面控件布局
     void initUI();
-    // 按路径点创建敌人路径
-    void createPath();
     // 弹出游戏失败结果面板
     void showGameOverDialog();
     // 弹出关卡完成结果面板
@@ -77,24 +78,28 @@ private:
     void hidePauseMenu();
     // 保存关卡进度与评分
     void saveLevelProgress(bool levelCompleted);
+    // 序列化当前对局并在后台写入自动存档
+    void autosave();
 
-    // 绘制地图背景贴图
-    void drawBackground();
-    // 绘制调试用网格线
-    void drawGrid();
+    // 放置关卡静态底图与主角
+    void drawBackground(const QPixmap &staticLayer);
 
     // 更新鼠标悬停高亮格
     void updateHoverHighlight(const QPointF &scenePos);
-    // 初始化建塔位置校验器
-    void initPlacementValidator();
     // 刷新面板上的游戏统计
     void updateGameStats();
-    // 绘制可建塔区域高亮
-    void drawPlacementAreas();
     // 显示短暂悬浮提示文字
     void showFloatingTip(const QString &text, const QPointF &scenePos, const QColor &color);
     // 播放升级特效动画
     void showUpgradeEffect(const QPointF &scenePos);
+    // 初始化性能分析叠加层
+    void initProfilerOverlay();
+    // 切换性能分析叠加层显示
+    void toggleProfilerOverlay();
+    // 刷新性能分析叠加层文本
+    void refreshProfilerOverlay();
+    // 导出时间线到 Chrome Trace 文件
+    void dumpTrace();
     
     // 暂停所有敌人移动
     void pauseAllEnemies();
@@ -127,7 +132,6 @@ private:
     QGraphicsScene *gameScene;
     QGraphicsView *gameView;
     QGraphicsPixmapItem *userItem;
-    PlacementValidator *placementValidator;
     GameManager *gameManager;
 
     QWidget *controlPanel;
@@ -140,17 +144,21 @@ private:
     QWidget *resultPanel;
     QWidget *pauseOverlay;
     QWidget *pausePanel;
+    QLabel *profilerOverlay;
+    QTimer *profilerRefreshTimer;
 
     QVBoxLayout *mainLayout;
     QHBoxLayout *infoLayout;
     QHBoxLayout *buttonLayout;
 
-    QVector<QPointF> pathPoints;
 
     GameConfig::MapId currentMapId;
     QVector<GameConfig::EndPointConfig> endPointAreas;
     QElapsedTimer elapsedTimer;
-    QList<QGraphicsRectItem *> placementAreaItems;
+    // 从选定地图到首个模拟帧的耗时
+    QElapsedTimer levelStartClock;
+    // 已死亡、等待尸体消失的敌人
+    QList<QPointer<Enemy>> dyingEnemies;
 };
 
 #endif
@@ -0,0 +1,63 @@
+#ifndef GAMERANDOM_H
+#define GAMERANDOM_H
+
+#include <QtGlobal>
+
+// 玩法用的确定性随机数（PCG32），状态只有一个 64 位整数，便于快照与存档
+class GameRandom
+{
+public:
+    // 以给定种子构造
+    explicit GameRandom(quint64 seedValue = 0x853c49e6748fea9bULL)
+    {
+        seed(seedValue);
+    }
+
+    // 重新播种
+    void seed(quint64 seedValue)
+    {
+        currentState = 0;
+        generate();
+        currentState += seedValue;
+        generate();
+    }
+
+    // 生成下一个 32 位随机数
+    quint32 generate()
+    {
+        quint64 oldState = currentState;
+        currentState = oldState * MULTIPLIER + INCREMENT;
+        quint32 xorShifted = static_cast<quint32>(((oldState >> 18u) ^ oldState) >> 27u);
+        quint32 rotation = static_cast<quint32>(oldState >> 59u);
+        return (xorShifted >> rotation) | (xorShifted << ((32u - rotation) & 31u));
+    }
+
+    // 生成 [0, highest) 内均匀分布的整数
+    int bounded(int highest)
+    {
+        if (highest <= 1)
+            return 0;
+        // 拒绝落在不完整区间的样本，避免取模偏差
+        quint32 bound = static_cast<quint32>(highest);
+        quint32 threshold = (0u - bound) % bound;
+        for (;;)
+        {
+            quint32 value = generate();
+            if (value >= threshold)
+                return static_cast<int>(value % bound);
+        }
+    }
+
+    // 读取内部状态用于存档
+    quint64 state() const { return currentState; }
+    // 从存档恢复内部状态
+    void setState(quint64 value) { currentState = value; }
+
+private:
+    static const quint64 MULTIPLIER = 6364136223846793005ULL;
+    static const quint64 INCREMENT = 1442695040888963407ULL;
+
+    quint64 currentState;
+};
+
+#endif // GAMERANDOM_H
@@ -0,0 +1,20 @@
+#ifndef GAMEVIEW_H
+#define GAMEVIEW_H
+
+#include <QGraphicsView>
+
+// 带绘制耗时统计的游戏视图
+class GameView : public QGraphicsView
+{
+    Q_OBJECT
+
+public:
+    // 创建游戏场景视图
+    explicit GameView(QWidget *parent = nullptr);
+
+protected:
+    // 统计场景绘制耗时
+    void paintEvent(QPaintEvent *event) override;
+};
+
+#endif // GAMEVIEW_H
@@ -0,0 +1,39 @@
+#ifndef LANEPATH_H
+#define LANEPATH_H
+
+#include <QPointF>
+#include <QVector>
+
+// 一条出兵路线按弧长参数化后的只读数据，同一路线上的敌人共享一份
+class LanePath
+{
+public:
+    // 按路径点预先算好各段单位方向、长度与起点累计距离
+    explicit LanePath(const QVector<QPointF> &points = QVector<QPointF>());
+
+    // 路线是否没有任何路径点
+    bool isEmpty() const { return waypoints.isEmpty(); }
+    // 路线段数
+    int segmentCount() const { return segmentStarts.size(); }
+    // 路线总长
+    qreal totalLength() const { return length; }
+    // 路线起点
+    QPointF start() const { return waypoints.isEmpty() ? QPointF() : waypoints.first(); }
+    // 原始路径点
+    const QVector<QPointF> &points() const { return waypoints; }
+
+    // 弧长所在的段下标，路线不足一段时为 -1
+    int segmentAt(qreal distance) const;
+    // 弧长处的坐标，超出两端时取端点
+    QPointF pointAt(qreal distance) const;
+
+private:
+    QVector<QPointF> waypoints;
+    // 每段的单位方向，零长度段为零向量
+    QVector<QPointF> directions;
+    // 每段起点距路线起点的弧长
+    QVector<qreal> segmentStarts;
+    qreal length;
+};
+
+#endif // LANEPATH_H
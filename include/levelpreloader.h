@@ -0,0 +1,67 @@
+#ifndef LEVELPRELOADER_H
+#define LEVELPRELOADER_H
+
+#include "config.h"
+#include "placementvalidator.h"
+#include "lanepath.h"
+#include <QObject>
+#include <QImage>
+#include <QPixmap>
+#include <QMap>
+#include <QSet>
+#include <QVector>
+#include <QPointF>
+#include <QSharedPointer>
+
+// 一个关卡进入前即可备好的静态数据
+struct PreparedLevel
+{
+    GameConfig::MapId mapId = GameConfig::MAP1;
+    QVector<QSharedPointer<const LanePath>> lanePaths;
+    QVector<GameConfig::EndPointConfig> endPoints;
+    PlacementValidator placement;
+    // 地图、网格线与可建造格烘焙成的一张静态底图，转成贴图后即清空
+    QImage staticLayer;
+};
+
+// 在后台线程预先构建关卡静态数据，点击地图时直接取用
+class LevelPreloader : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 获取全局单例预加载器
+    static LevelPreloader &instance();
+
+    // 在线程池中准备指定关卡，已就绪或进行中时忽略
+    void prepareAsync(GameConfig::MapId mapId);
+    // 查询指定关卡是否已准备完成
+    bool isReady(GameConfig::MapId mapId) const { return prepared.contains(mapId); }
+    // 取得准备好的关卡，尚未就绪时在当前线程同步构建
+    PreparedLevel acquire(GameConfig::MapId mapId);
+    // 取得关卡静态底图的贴图，须先 acquire
+    QPixmap staticPixmap(GameConfig::MapId mapId) const { return pixmaps.value(mapId); }
+
+    // 构建关卡静态数据，可在任意线程调用
+    static PreparedLevel buildLevel(GameConfig::MapId mapId);
+
+signals:
+    // 指定关卡已在后台准备完成
+    void levelPrepared(GameConfig::MapId mapId);
+
+private:
+    // 私有构造仅供单例使用
+    LevelPreloader();
+
+    // 在图片上绘制地图、网格与可建造格
+    static QImage renderStaticLayer(GameConfig::MapId mapId, const PlacementValidator &placement);
+    // 在 GUI 线程把静态底图转成贴图并收下关卡，已有同一关卡时忽略
+    void store(PreparedLevel level);
+
+    QMap<GameConfig::MapId, PreparedLevel> prepared;
+    // 贴图只能在 GUI 线程创建与销毁，与工作线程产出的数据分开保存
+    QMap<GameConfig::MapId, QPixmap> pixmaps;
+    QSet<GameConfig::MapId> inFlight;
+};
+
+#endif // LEVELPRELOADER_H
@@ -7,6 +7,7 @@
 class QPushButton;
 class QLabel;
 class QVBoxLayout;
+class QShowEvent;
 
 namespace Ui
 {
@@ -35,14 +36,22 @@ private slots:
     void onMap1Clicked();
     // 地图二按钮点击响应
     void onMap2Clicked();
+    // 地图三按钮点击响应
+    void onMap3Clicked();
     // 取消返回主菜单响应
     void onCancelClicked();
+    // 填入已缓存的地图预览图
+    void showMapPreviews();
+    // 从内存进度刷新关卡状态
+    void loadProgress();
+
+protected:
+    // 页面可见时在后台预备最可能进入的关卡
+    void showEvent(QShowEvent *event) override;
 
 private:
     // 初始化关卡选择界面布局
     void initUI();
-    // 从存档加载关卡进度
-    void loadProgress();
 
     Ui::LevelSelectPage *ui;
 
@@ -51,7 +60,11 @@ private:
     QLabel *map2StatusLabel;
     QLabel *map1WaveLabel;
     QLabel *map2WaveLabel;
+    QLabel *map3StatusLabel;
+    QLabel *map3WaveLabel;
     QPushButton *map2Button;
+    QPushButton *map3Button;
+    int unlockedMaxIndex;
 };
 
 #endif
@@ -0,0 +1,133 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include "eventring.h"
+#include <QElapsedTimer>
+#include <QString>
+#include <atomic>
+
+// 编译期日志门限：低于该级别的日志宏展开为空语句
+// 0 = trace, 1 = debug, 2 = info, 3 = warn
+#ifndef TE_LOG_MIN_LEVEL
+#ifdef QT_NO_DEBUG
+#define TE_LOG_MIN_LEVEL 3
+#else
+#define TE_LOG_MIN_LEVEL 1
+#endif
+#endif
+
+class QObject;
+
+// 二进制记录、延迟格式化的结构化日志
+class Logger
+{
+public:
+    // 日志级别
+    enum Level
+    {
+        LEVEL_TRACE = 0,
+        LEVEL_DEBUG = 1,
+        LEVEL_INFO = 2,
+        LEVEL_WARN = 3
+    };
+
+    // 日志分类
+    enum Category
+    {
+        CATEGORY_GAME = 0,
+        CATEGORY_TOWER,
+        CATEGORY_BULLET,
+        CATEGORY_INPUT,
+        CATEGORY_COUNT
+    };
+
+    // 单条日志最多携带的数值参数
+    static const int MAX_ARGS = 6;
+
+    // 二进制日志记录：格式串为静态字符串，参数以数值保存
+    struct Record
+    {
+        qint64 timestampNs;
+        const char *format;
+        double args[MAX_ARGS];
+        quint8 argCount;
+        quint8 level;
+        quint8 category;
+    };
+
+    // 获取全局单例日志器
+    static Logger &instance();
+
+    // 写入一条日志（仅拷贝数值，不做格式化）
+    template <typename... Args>
+    void record(Level level, Category category, const char *format, Args... args)
+    {
+        static_assert(sizeof...(Args) <= MAX_ARGS, "too many log arguments");
+        if (!isCategoryEnabled(category))
+            return;
+
+        const double values[] = {0.0, static_cast<double>(args)...};
+        Record entry;
+        entry.timestampNs = clock.nsecsElapsed();
+        entry.format = format;
+        entry.argCount = static_cast<quint8>(sizeof...(Args));
+        entry.level = static_cast<quint8>(level);
+        entry.category = static_cast<quint8>(category);
+        for (int i = 0; i < entry.argCount; ++i)
+            entry.args[i] = values[i + 1];
+        records.push(entry);
+    }
+
+    // 开启或关闭某个分类
+    void setCategoryEnabled(Category category, bool enabled);
+    // 查询分类是否开启
+    bool isCategoryEnabled(Category category) const
+    {
+        return (categoryMask.load(std::memory_order_relaxed) & (1u << category)) != 0;
+    }
+
+    // 格式化并输出尚未输出的日志
+    void flush();
+    // 在指定对象上启动定时输出
+    void startFlushTimer(QObject *owner, int intervalMs = 500);
+
+    // 获取分类显示名称
+    static const char *categoryName(Category category);
+    // 将记录格式化为文本
+    static QString format(const Record &entry);
+
+private:
+    // 私有构造仅供单例使用
+    Logger();
+
+    EventRing<Record, 4096> records;
+    quint64 flushCursor;
+    QElapsedTimer clock;
+    std::atomic<quint32> categoryMask;
+};
+
+#if TE_LOG_MIN_LEVEL <= 0
+#define LOG_TRACE(category, ...) Logger::instance().record(Logger::LEVEL_TRACE, Logger::category, __VA_ARGS__)
+#else
+#define LOG_TRACE(category, ...) do { } while (0)
+#endif
+
+#if TE_LOG_MIN_LEVEL <= 1
+#define LOG_DEBUG(category, ...) Logger::instance().record(Logger::LEVEL_DEBUG, Logger::category, __VA_ARGS__)
+#else
+#define LOG_DEBUG(category, ...) do { } while (0)
+#endif
+
+#if TE_LOG_MIN_LEVEL <= 2
+#define LOG_INFO(category, ...) Logger::instance().record(Logger::LEVEL_INFO, Logger::category, __VA_ARGS__)
+#else
+#define LOG_INFO(category, ...) do { } while (0)
+#endif
+
+#if TE_LOG_MIN_LEVEL <= 3
+#define LOG_WARN(category, ...) Logger::instance().record(Logger::LEVEL_WARN, Logger::category, __VA_ARGS__)
+#else
+#define LOG_WARN(category, ...) do { } while (0)
+#endif
+
+#endif // LOGGER_H
@@ -8,6 +8,7 @@
 class QPushButton;
 class QLabel;
 class QVBoxLayout;
+class QProgressBar;
 
 namespace Ui
 {
@@ -38,6 +39,8 @@ private slots:
     void onStartButtonClicked();
     // 退出按钮点击响应
     void onExitButtonClicked();
+    // 资源预加载进度更新
+    void onLoadProgress(int loaded, int total);
 
 private:
     // 初始化主菜单界面布局
@@ -53,6 +56,7 @@ private:
     QPushButton *exitButton;
     QVBoxLayout *buttonLayout;
     QVBoxLayout *mainLayout;
+    QProgressBar *loadingBar;
 
     QPixmap backgroundImage;
 };
@@ -25,12 +25,21 @@ public:
     void switchToGamePage(GameConfig::MapId mapId);
     // 切换回主菜单界面
     void switchToMainMenu();
+    // 切换到关卡选择界面
+    void switchToLevelSelect();
+    // 在事件循环空闲时逐个预建尚未创建的页面
+    void prebuildPagesWhenIdle();
 
 private slots:
     // 游戏结束回调处理
     void onGameOver();
 
 private:
+    // 首次需要时创建关卡选择页面
+    LevelSelectPage *ensureLevelSelectPage();
+    // 首次需要时创建游戏页面
+    GamePage *ensureGamePage();
+
     QStackedWidget *stackedWidget;
     GamePage *gamePage;
     MainMenuPage *mainMenuPage;
@@ -0,0 +1,88 @@
+#ifndef OCCUPANCYGRID_H
+#define OCCUPANCYGRID_H
+
+#include "config.h"
+#include <QPointer>
+#include <QPointF>
+#include <QVector>
+
+class Tower;
+
+// 按网格记录可建造、路径与占用标记，以及每格上的防御塔
+class OccupancyGrid
+{
+public:
+    // 单元格标记位
+    enum CellFlag
+    {
+        CELL_BUILDABLE = 0x01,
+        CELL_PATH = 0x02,
+        CELL_OCCUPIED = 0x04,
+        CELL_END = 0x08
+    };
+
+    // 构造覆盖整个窗口的空网格
+    OccupancyGrid();
+
+    // 按地图配置生成路径、终点与可建造标记
+    static OccupancyGrid buildForMap(GameConfig::MapId mapId);
+
+    // 网格列数
+    int columns() const { return cols; }
+    // 网格行数
+    int rows() const { return rowCount; }
+    // 格子坐标是否在网格内
+    bool contains(int cellX, int cellY) const
+    {
+        return cellX >= 0 && cellY >= 0 && cellX < cols && cellY < rowCount;
+    }
+    // 像素坐标所在格子的列号
+    static int cellX(const QPointF &pixel) { return static_cast<int>(pixel.x()) / GameConfig::GRID_SIZE; }
+    // 像素坐标所在格子的行号
+    static int cellY(const QPointF &pixel) { return static_cast<int>(pixel.y()) / GameConfig::GRID_SIZE; }
+
+    // 读取格子全部标记，越界视为空
+    quint8 flags(int cellX, int cellY) const
+    {
+        return contains(cellX, cellY) ? cells[index(cellX, cellY)] : 0;
+    }
+    // 格子是否在敌人路径上
+    bool isPath(int cellX, int cellY) const { return flags(cellX, cellY) & CELL_PATH; }
+    // 格子是否为终点区域
+    bool isEndZone(int cellX, int cellY) const { return flags(cellX, cellY) & CELL_END; }
+    // 格子是否已有防御塔
+    bool isOccupied(int cellX, int cellY) const { return flags(cellX, cellY) & CELL_OCCUPIED; }
+    // 敌人能否走进格子：地形可走且没有塔
+    bool isWalkable(int cellX, int cellY) const
+    {
+        quint8 cell = flags(cellX, cellY);
+        return (cell & (CELL_BUILDABLE | CELL_PATH)) && !(cell & CELL_OCCUPIED);
+    }
+    // 格子当前能否新建防御塔
+    bool canBuild(int cellX, int cellY) const
+    {
+        return (flags(cellX, cellY) & (CELL_BUILDABLE | CELL_PATH | CELL_OCCUPIED)) == CELL_BUILDABLE;
+    }
+    // 取格子上的防御塔，没有时为空
+    Tower *towerAt(int cellX, int cellY) const;
+
+    // 标记格子已被防御塔占用
+    void setTower(int cellX, int cellY, Tower *tower);
+    // 清除格子上的防御塔
+    void clearTower(int cellX, int cellY);
+    // 清除所有防御塔，保留地形标记
+    void clearTowers();
+
+private:
+    // 格子在一维数组中的下标
+    int index(int cellX, int cellY) const { return cellY * cols + cellX; }
+    // 把两点之间的水平或竖直线段上的格子标为路径
+    void markPathSegment(const GameConfig::GridPoint &from, const GameConfig::GridPoint &to);
+
+    int cols;
+    int rowCount;
+    QVector<quint8> cells;
+    QVector<QPointer<Tower>> towers;
+};
+
+#endif // OCCUPANCYGRID_H
@@ -0,0 +1,56 @@
+#ifndef PROGRESSSTORE_H
+#define PROGRESSSTORE_H
+
+#include "config.h"
+#include <QObject>
+#include <QMap>
+#include <QByteArray>
+#include <QFuture>
+
+// 关卡进度的内存存储，读取走内存，修改在后台原子写盘
+class ProgressStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 获取全局单例进度存储
+    static ProgressStore &instance();
+
+    // 指定地图的最高波次，未挑战为 0
+    int bestWave(GameConfig::MapId mapId) const { return bestWaves.value(mapId, 0); }
+    // 已解锁的最大地图序号
+    int unlockedMaxIndex() const { return unlockedMax; }
+
+    // 记录一局结果，有变化时更新内存并提交后台写盘
+    void recordResult(GameConfig::MapId mapId, int wave, bool levelCompleted);
+    // 等待已提交的写盘完成，退出前调用
+    void waitForPendingWrites();
+
+    // 进度文件路径
+    static QString progressPath();
+
+signals:
+    // 内存中的进度发生变化
+    void progressChanged();
+
+private:
+    // 私有构造仅供单例使用
+    ProgressStore();
+
+    // 读取进度文件，不存在时从旧版 QSettings 迁移
+    void load();
+    // 从旧版 QSettings 键读取进度
+    void loadLegacySettings();
+    // 序列化当前进度
+    QByteArray serialize() const;
+    // 解析进度文件内容
+    bool deserialize(const QByteArray &data);
+    // 把当前进度快照交给线程池写盘
+    void submitWrite();
+
+    QMap<GameConfig::MapId, int> bestWaves;
+    int unlockedMax;
+    QFuture<void> lastWrite;
+};
+
+#endif // PROGRESSSTORE_H
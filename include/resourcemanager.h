@@ -7,6 +7,9 @@
 #include <QMap>
 #include <QString>
 #include <QHash>
+#include <QImage>
+#include <QStringList>
+#include <QVector>
 
 // 管理图片与音效等共享资源
 // AI-generated class
@@ -57,6 +60,16 @@ public:
 
     // 播放或循环播放音效
     void playSound(const QString &soundId, qreal volume = 1.0, bool loop = false);
+    // 开始收集本帧音效请求，可嵌套
+    void beginSoundBatch();
+    // 按音效合并本帧请求并统一播放
+    void flushSoundBatch();
+    // 关闭音频线程与输出设备，退出前调用
+    void stopAudio();
+    // 开关全部音效播放
+    void setSoundEnabled(bool enabled) { soundEnabled = enabled; }
+    // 查询音效是否开启
+    bool isSoundEnabled() const { return soundEnabled; }
 
     // 获取默认子弹贴图
     QPixmap getBulletPixmap() const;
@@ -87,6 +100,23 @@ public:
     QPixmap getGameMap() const;
     // 获取指定地图ID贴图
     QPixmap getGameMap(GameConfig::MapId mapId) const;
+    // 获取关卡选择用的地图预览图
+    QPixmap getMapPreview(GameConfig::MapId mapId) const;
+    // 地图原图的资源路径
+    static QString mapResourcePath(GameConfig::MapId mapId);
+
+    // 在线程池中异步解码全部贴图与音效
+    void preloadAssetsAsync();
+    // 查询异步预加载是否全部完成
+    bool isPreloadFinished() const { return preloadStarted && assetsLoaded >= assetsTotal; }
+
+signals:
+    // 单个资源解码完成并进入缓存
+    void assetLoaded(const QString &key);
+    // 预加载进度更新
+    void loadProgress(int loaded, int total);
+    // 全部资源预加载完成
+    void assetsReady();
 
 private:
     // 私有构造仅供单例使用
@@ -94,15 +124,59 @@ private:
     // 默认析构释放资源
     ~ResourceManager() = default;
 
-    QMap<QString, QPixmap> pixmapCache;
-    QHash<QString, QList<class QSoundEffect*>> soundEffectPool;
+    // 一张源图解码后缩放出的目标贴图
+    struct ImageTarget
+    {
+        QString key;
+        QSize size;
+        Qt::AspectRatioMode mode;
+    };
+
+    // 一次解码任务：按顺序尝试候选路径，命中后生成所有目标
+    struct ImageJob
+    {
+        QStringList paths;
+        QList<ImageTarget> targets;
+    };
+
+    mutable QMap<QString, QPixmap> pixmapCache;
+    // 一帧内同一音效的合并请求
+    struct PendingSound
+    {
+        int count;
+        qreal maxVolume;
+        bool loop;
+    };
+
+    class AudioMixer *audioMixer;
+    bool soundEnabled;
+    bool soundsLoaded;
+    int soundBatchDepth;
+    QHash<QString, PendingSound> pendingSounds;
+
+    bool preloadStarted;
+    int assetsTotal;
+    int assetsLoaded;
+    int soundsPending;
 
     // 加载默认占位图片资源
     void loadDefaultPixmaps();
-    // 预创建常用音效对象池
+    // 同步解码常用音效到混音器（未异步预加载时的兜底）
     void preloadDefaultSounds();
-    // 从池中获取可用音效对象
-    class QSoundEffect* acquireSoundEffect(const QString &soundId);
+    // 列出所有需要预解码的贴图任务
+    QList<ImageJob> buildImageJobs() const;
+    // 在工作线程解码并缩放一张源图
+    static QList<QImage> decodeImageJob(const ImageJob &job);
+    // GUI 线程接收解码结果并转换为贴图
+    void onImageDecoded(const QString &key, const QImage &image);
+    // GUI 线程接收解码好的音效
+    void onSoundDecoded(const QString &soundId, const QVector<qint16> &samples, int priority, int minIntervalMs);
+    // 记录一项资源完成并广播进度
+    void finishAsset(const QString &key);
+    // 敌人状态对应的文件名片段
+    static QString enemyStateName(EnemyState state);
+    // 直接交给混音器发声
+    void playSoundNow(const QString &soundId, qreal volume, bool loop);
 };
 
 #endif
@@ -0,0 +1,27 @@
+#ifndef SAVEGAME_H
+#define SAVEGAME_H
+
+#include <QByteArray>
+#include <QString>
+
+// 对局自动存档文件的读写，写盘在线程池中按提交顺序完成
+class SaveGame
+{
+public:
+    // 自动存档文件路径
+    static QString autosavePath();
+    // 是否存在自动存档
+    static bool hasAutosave();
+    // 同步读取自动存档内容
+    static QByteArray readAutosave();
+    // 在后台原子写入自动存档
+    static void writeAutosaveAsync(const QByteArray &data);
+    // 在后台删除自动存档
+    static void removeAutosaveAsync();
+
+private:
+    // 提交一次写入或删除，较旧的请求不会覆盖较新的结果
+    static void submit(const QByteArray &data, bool remove);
+};
+
+#endif // SAVEGAME_H
@@ -0,0 +1,52 @@
+#ifndef SIMDKERNELS_H
+#define SIMDKERNELS_H
+
+#include <QtGlobal>
+
+// 整批实体一次推进的向量化内核，运行时按 CPU 支持的指令集挑选实现
+namespace SimdKernels
+{
+    // 内核实现
+    enum Backend
+    {
+        BACKEND_SCALAR = 0,
+        BACKEND_SSE2 = 1,
+        BACKEND_AVX2 = 2
+    };
+
+    // 一批追踪子弹的连续存储，所有数组长度为 count
+    struct HomingBatch
+    {
+        float *x;
+        float *y;
+        // 单位方向
+        float *dirX;
+        float *dirY;
+        const float *targetX;
+        const float *targetY;
+        const float *speed;
+        // 输入为是否仍在追踪，输出转向过急时清零
+        qint32 *tracking;
+        // 输出本步是否命中目标，命中的子弹不再移动
+        qint32 *hit;
+        int count;
+    };
+
+    // 当前 CPU 支持的最快实现
+    Backend bestSupportedBackend();
+    // 当前使用的实现
+    Backend activeBackend();
+    // 指定实现，CPU 不支持时退到能用的最快实现，返回实际生效的实现
+    Backend setBackend(Backend backend);
+    // 实现名称，用于日志与基准输出
+    const char *backendName(Backend backend);
+
+    // progress[i] = min(progress[i] + speed[i] * steps[i], length[i])
+    void advanceProgress(float *progress, const float *speed, const float *steps, const float *length, int count);
+    // 追踪子弹走一步：判定命中、限角转向、沿新方向前进
+    void stepHoming(const HomingBatch &batch, float hitRadius, float cosMaxTurn, float sinMaxTurn);
+    // 按升序写出到圆心距离平方不超过 radiusSq 的点下标，返回个数；out 至少能放 count 个
+    int collectInRange(const float *x, const float *y, int count, float centerX, float centerY, float radiusSq, qint32 *out);
+}
+
+#endif // SIMDKERNELS_H
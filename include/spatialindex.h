@@ -0,0 +1,360 @@
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+#include <QVector>
+#include <QVarLengthArray>
+#include <QPair>
+#include <QPointF>
+#include <QRectF>
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+// 点集的扁平四叉树，元素类型不限（敌人、子弹、特效或数组下标）
+// - 每帧 clear 后逐个 insert，再 build 一次；节点放在同一数组里，重建时复用已分配的存储
+// - 矩形、圆、线段查询按插入顺序输出，k 近邻按距离升序、同距按插入顺序输出
+// - 查询复用内部暂存，同一实例不能在多个线程里同时查询
+template <typename T>
+class SpatialIndex
+{
+public:
+    // leafCapacity 为叶子最多容纳的元素数，maxDepth 限制重合点过多时的划分层数
+    explicit SpatialIndex(int leafCapacity = 8, int maxDepth = 8)
+        : leafCapacity(qMax(1, leafCapacity)),
+          maxDepth(qMax(0, maxDepth))
+    {
+    }
+
+    // 清空元素与节点，保留已分配的存储
+    void clear()
+    {
+        items.resize(0);
+        xs.resize(0);
+        ys.resize(0);
+        nodes.resize(0);
+    }
+
+    // 预留 count 个元素的存储
+    void reserve(int count)
+    {
+        items.reserve(count);
+        xs.reserve(count);
+        ys.reserve(count);
+    }
+
+    // 加入一个元素及其位置，build 之后才能被查到
+    void insert(const T &item, const QPointF &pos)
+    {
+        items.append(item);
+        xs.append(static_cast<float>(pos.x()));
+        ys.append(static_cast<float>(pos.y()));
+    }
+
+    // 元素个数
+    int size() const { return items.size(); }
+
+    // 按已加入的元素建树，根节点取元素包围盒
+    void build()
+    {
+        const int count = items.size();
+        nodes.resize(0);
+        order.resize(count);
+        orderScratch.resize(count);
+        for (int i = 0; i < count; ++i)
+            order[i] = i;
+        if (count == 0)
+            return;
+
+        float minX = xs[0];
+        float minY = ys[0];
+        float maxX = xs[0];
+        float maxY = ys[0];
+        for (int i = 1; i < count; ++i)
+        {
+            minX = qMin(minX, xs[i]);
+            minY = qMin(minY, ys[i]);
+            maxX = qMax(maxX, xs[i]);
+            maxY = qMax(maxY, ys[i]);
+        }
+        nodes.resize(1);
+        buildNode(0, 0, count, minX, minY, maxX, maxY, 0);
+    }
+
+    // 取出落在矩形内（含边界）的元素
+    void queryRect(const QRectF &rect, QVector<T> *out) const
+    {
+        const QRectF box = rect.normalized();
+        const float left = static_cast<float>(box.left());
+        const float top = static_cast<float>(box.top());
+        const float right = static_cast<float>(box.right());
+        const float bottom = static_cast<float>(box.bottom());
+        collect(
+            [=](const Node &node) {
+                return node.minX <= right && node.maxX >= left && node.minY <= bottom && node.maxY >= top;
+            },
+            [=](float x, float y) { return x >= left && x <= right && y >= top && y <= bottom; },
+            out);
+    }
+
+    // 取出与圆心距离不超过 radius 的元素
+    void queryCircle(const QPointF &center, qreal radius, QVector<T> *out) const
+    {
+        const float centerX = static_cast<float>(center.x());
+        const float centerY = static_cast<float>(center.y());
+        const float r = static_cast<float>(radius);
+        const float radiusSq = r * r;
+        collect(
+            [=](const Node &node) { return boxDistanceSq(node, centerX, centerY) <= radiusSq; },
+            [=](float x, float y) {
+                const float dx = x - centerX;
+                const float dy = y - centerY;
+                return dx * dx + dy * dy <= radiusSq;
+            },
+            out);
+    }
+
+    // 取出与线段距离不超过 radius 的元素；radius 为 0 时只取线段正好经过的点
+    void querySegment(const QPointF &from, const QPointF &to, qreal radius, QVector<T> *out) const
+    {
+        const float fromX = static_cast<float>(from.x());
+        const float fromY = static_cast<float>(from.y());
+        const float dx = static_cast<float>(to.x()) - fromX;
+        const float dy = static_cast<float>(to.y()) - fromY;
+        const float lengthSq = dx * dx + dy * dy;
+        const float r = static_cast<float>(radius);
+        const float radiusSq = r * r;
+        collect(
+            // 节点盒外扩 radius 后与线段求交，角上略有多余但不会漏
+            [=](const Node &node) {
+                return segmentHitsBox(fromX, fromY, dx, dy,
+                                      node.minX - r, node.minY - r, node.maxX + r, node.maxY + r);
+            },
+            [=](float x, float y) {
+                float t = lengthSq > 0.0f ? ((x - fromX) * dx + (y - fromY) * dy) / lengthSq : 0.0f;
+                t = qBound(0.0f, t, 1.0f);
+                const float offsetX = x - (fromX + dx * t);
+                const float offsetY = y - (fromY + dy * t);
+                return offsetX * offsetX + offsetY * offsetY <= radiusSq;
+            },
+            out);
+    }
+
+    // 取出离 center 最近的至多 k 个元素，maxDistance 之外的不算
+    void queryNearest(const QPointF &center, int k, QVector<T> *out,
+                      qreal maxDistance = std::numeric_limits<qreal>::max()) const
+    {
+        out->resize(0);
+        if (nodes.isEmpty() || k <= 0)
+            return;
+
+        const float centerX = static_cast<float>(center.x());
+        const float centerY = static_cast<float>(center.y());
+        const qreal maxDistanceSq = maxDistance * maxDistance;
+        const float limitSq = maxDistanceSq >= std::numeric_limits<float>::max()
+            ? std::numeric_limits<float>::max()
+            : static_cast<float>(maxDistanceSq);
+
+        // 节点按盒距离从近到远展开；best 是按 (距离, 插入序号) 的大顶堆，堆顶为当前第 k 名
+        typedef QPair<float, int> Entry;
+        std::greater<Entry> farther;
+        nodeQueue.resize(0);
+        best.resize(0);
+        nodeQueue.append(Entry(boxDistanceSq(nodes[0], centerX, centerY), 0));
+        while (!nodeQueue.isEmpty())
+        {
+            std::pop_heap(nodeQueue.begin(), nodeQueue.end(), farther);
+            const Entry next = nodeQueue.last();
+            nodeQueue.removeLast();
+            // 同距的点仍可能以更小的插入序号胜出，只在严格更远时停止
+            if (next.first > limitSq || (best.size() == k && next.first > best.first().first))
+                break;
+
+            const Node &node = nodes[next.second];
+            if (node.firstChild >= 0)
+            {
+                for (int child = node.firstChild; child < node.firstChild + 4; ++child)
+                {
+                    nodeQueue.append(Entry(boxDistanceSq(nodes[child], centerX, centerY), child));
+                    std::push_heap(nodeQueue.begin(), nodeQueue.end(), farther);
+                }
+                continue;
+            }
+
+            for (int slot = node.begin; slot < node.end; ++slot)
+            {
+                const int i = order[slot];
+                const float dx = xs[i] - centerX;
+                const float dy = ys[i] - centerY;
+                const Entry candidate(dx * dx + dy * dy, i);
+                if (candidate.first > limitSq)
+                    continue;
+                if (best.size() < k)
+                {
+                    best.append(candidate);
+                    std::push_heap(best.begin(), best.end());
+                }
+                else if (candidate < best.first())
+                {
+                    std::pop_heap(best.begin(), best.end());
+                    best.last() = candidate;
+                    std::push_heap(best.begin(), best.end());
+                }
+            }
+        }
+
+        std::sort_heap(best.begin(), best.end());
+        out->reserve(best.size());
+        for (const Entry &entry : best)
+            out->append(items[entry.second]);
+    }
+
+private:
+    // 节点盒与覆盖的元素区间，四个子节点在节点数组里连续存放
+    struct Node
+    {
+        float minX;
+        float minY;
+        float maxX;
+        float maxY;
+        int firstChild;
+        int begin;
+        int end;
+    };
+
+    // 点到节点盒的最近距离平方，点在盒内为 0
+    static float boxDistanceSq(const Node &node, float x, float y)
+    {
+        const float dx = qMax(qMax(node.minX - x, x - node.maxX), 0.0f);
+        const float dy = qMax(qMax(node.minY - y, y - node.maxY), 0.0f);
+        return dx * dx + dy * dy;
+    }
+
+    // 线段 from + t * delta（t ∈ [0, 1]）是否与盒相交，逐轴收窄 t 的区间
+    static bool segmentHitsBox(float fromX, float fromY, float deltaX, float deltaY,
+                               float minX, float minY, float maxX, float maxY)
+    {
+        float enter = 0.0f;
+        float exit = 1.0f;
+        return clipAxis(fromX, deltaX, minX, maxX, &enter, &exit)
+            && clipAxis(fromY, deltaY, minY, maxY, &enter, &exit);
+    }
+
+    static bool clipAxis(float from, float delta, float low, float high, float *enter, float *exit)
+    {
+        if (delta == 0.0f)
+            return from >= low && from <= high;
+        float first = (low - from) / delta;
+        float second = (high - from) / delta;
+        if (first > second)
+            std::swap(first, second);
+        *enter = qMax(*enter, first);
+        *exit = qMin(*exit, second);
+        return *enter <= *exit;
+    }
+
+    // 填写一个节点，元素过多时按象限重排下标并继续划分
+    void buildNode(int nodeIndex, int begin, int end, float minX, float minY, float maxX, float maxY, int depth)
+    {
+        Node node = { minX, minY, maxX, maxY, -1, begin, end };
+        nodes[nodeIndex] = node;
+        if (end - begin <= leafCapacity || depth >= maxDepth)
+            return;
+
+        // 按象限做一趟计数排序（0 左上、1 右上、2 左下、3 右下），象限号无分支计算；
+        // 稳定重排，叶内下标保持插入顺序
+        const float midX = (minX + maxX) * 0.5f;
+        const float midY = (minY + maxY) * 0.5f;
+        const float *x = xs.constData();
+        const float *y = ys.constData();
+        int *slots = order.data();
+        int *sorted = orderScratch.data();
+        int quadrantStart[5] = { begin, 0, 0, 0, 0 };
+        int counts[4] = { 0, 0, 0, 0 };
+        for (int slot = begin; slot < end; ++slot)
+        {
+            const int i = slots[slot];
+            counts[int(x[i] >= midX) | (int(y[i] >= midY) << 1)]++;
+        }
+        for (int quadrant = 0; quadrant < 4; ++quadrant)
+            quadrantStart[quadrant + 1] = quadrantStart[quadrant] + counts[quadrant];
+        int cursor[4] = { quadrantStart[0], quadrantStart[1], quadrantStart[2], quadrantStart[3] };
+        for (int slot = begin; slot < end; ++slot)
+        {
+            const int i = slots[slot];
+            sorted[cursor[int(x[i] >= midX) | (int(y[i] >= midY) << 1)]++] = i;
+        }
+        std::copy(sorted + begin, sorted + end, slots + begin);
+
+        // 子节点整组追加；递归会让数组扩容，之后只按下标访问
+        const int firstChild = nodes.size();
+        nodes.resize(firstChild + 4);
+        nodes[nodeIndex].firstChild = firstChild;
+        buildNode(firstChild, quadrantStart[0], quadrantStart[1], minX, minY, midX, midY, depth + 1);
+        buildNode(firstChild + 1, quadrantStart[1], quadrantStart[2], midX, minY, maxX, midY, depth + 1);
+        buildNode(firstChild + 2, quadrantStart[2], quadrantStart[3], minX, midY, midX, maxY, depth + 1);
+        buildNode(firstChild + 3, quadrantStart[3], end, midX, midY, maxX, maxY, depth + 1);
+    }
+
+    // 自根向下展开 nodeTest 通过的节点，叶内满足 pointTest 的元素记入位图，再按插入顺序输出
+    template <typename NodeTest, typename PointTest>
+    void collect(const NodeTest &nodeTest, const PointTest &pointTest, QVector<T> *out) const
+    {
+        out->resize(0);
+        if (nodes.isEmpty())
+            return;
+
+        hitMask.fill(0, (items.size() + 31) / 32);
+        QVarLengthArray<int, 64> stack;
+        stack.append(0);
+        while (!stack.isEmpty())
+        {
+            const Node &node = nodes[stack.last()];
+            stack.removeLast();
+            if (!nodeTest(node))
+                continue;
+
+            if (node.firstChild >= 0)
+            {
+                for (int child = node.firstChild; child < node.firstChild + 4; ++child)
+                    stack.append(child);
+                continue;
+            }
+
+            for (int slot = node.begin; slot < node.end; ++slot)
+            {
+                const int i = order[slot];
+                if (pointTest(xs[i], ys[i]))
+                    hitMask[i >> 5] |= 1u << (i & 31);
+            }
+        }
+
+        for (int word = 0; word < hitMask.size(); ++word)
+        {
+            const quint32 bits = hitMask[word];
+            if (!bits)
+                continue;
+            for (int bit = 0; bit < 32; ++bit)
+            {
+                if (bits & (1u << bit))
+                    out->append(items[word * 32 + bit]);
+            }
+        }
+    }
+
+    int leafCapacity;
+    int maxDepth;
+
+    QVector<T> items;
+    QVector<float> xs;
+    QVector<float> ys;
+    QVector<Node> nodes;
+    // 按叶子分组的元素下标，每个节点覆盖其中一段
+    QVector<int> order;
+    QVector<int> orderScratch;
+
+    mutable QVector<quint32> hitMask;
+    mutable QVector<QPair<float, int>> nodeQueue;
+    mutable QVector<QPair<float, int>> best;
+};
+
+#endif // SPATIALINDEX_H
@@ -0,0 +1,60 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <QtGlobal>
+#include <atomic>
+
+// 单生产者单消费者无锁定长队列
+// - 生产者只写 tail，消费者只写 head，两端都不会阻塞
+// - 队列满时 tryPush 返回 false，由调用方决定是否丢弃
+template <typename T, int Capacity>
+class SpscQueue
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscQueue capacity must be a power of two");
+
+public:
+    SpscQueue()
+        : head(0),
+          tail(0)
+    {
+    }
+
+    // 生产者线程写入一项，满时返回 false
+    bool tryPush(const T &value)
+    {
+        quint32 currentTail = tail.load(std::memory_order_relaxed);
+        if (currentTail - head.load(std::memory_order_acquire) == static_cast<quint32>(Capacity))
+            return false;
+
+        slots[currentTail & (Capacity - 1)] = value;
+        tail.store(currentTail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者线程取出一项，空时返回 false
+    bool tryPop(T *value)
+    {
+        quint32 currentHead = head.load(std::memory_order_relaxed);
+        if (currentHead == tail.load(std::memory_order_acquire))
+            return false;
+
+        *value = slots[currentHead & (Capacity - 1)];
+        head.store(currentHead + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 当前排队数量（仅作参考，两端并发时可能已过期）
+    int sizeApprox() const
+    {
+        return static_cast<int>(tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire));
+    }
+
+private:
+    // 头尾分处不同缓存行，避免生产者与消费者互相失效
+    alignas(64) std::atomic<quint32> head;
+    alignas(64) std::atomic<quint32> tail;
+    T slots[Capacity];
+};
+
+#endif // SPSCQUEUE_H
@@ -0,0 +1,62 @@
+#ifndef STARTUPTIMELINE_H
+#define STARTUPTIMELINE_H
+
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QVector>
+
+class QWidget;
+
+// 记录进程启动到主菜单首帧绘制的各阶段时间点
+class StartupTimeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 获取全局单例时间线
+    static StartupTimeline &instance();
+
+    // 记录一个启动阶段（距进程启动的毫秒数）
+    void mark(const char *name);
+    // 在控件首次绘制完成时记录阶段并结束时间线
+    void markOnFirstPaint(QWidget *widget, const char *name);
+    // 距进程启动经过的毫秒数
+    qint64 elapsedMs() const;
+
+    // 时间线是否已记录到首帧
+    bool isFinished() const { return done; }
+    // 首帧时间是否在预算内
+    bool withinBudget() const;
+    // 生成各阶段耗时报告
+    QString report() const;
+
+signals:
+    // 首帧绘制已记录
+    void finished();
+
+protected:
+    // 监听目标控件的绘制事件
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    // 私有构造仅供单例使用
+    StartupTimeline();
+
+    // 一个启动阶段的时间点
+    struct Milestone
+    {
+        const char *name;
+        qint64 ms;
+    };
+
+    // 首帧绘制刷新到屏幕后收尾
+    void finishFirstPaint();
+
+    QVector<Milestone> milestones;
+    QPointer<QWidget> paintWidget;
+    const char *paintMarkName;
+    bool done;
+};
+
+#endif // STARTUPTIMELINE_H
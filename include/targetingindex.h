@@ -0,0 +1,59 @@
+#ifndef TARGETINGINDEX_H
+#define TARGETINGINDEX_H
+
+#include "spatialindex.h"
+#include <QVector>
+
+// 塔索敌的范围查询：按本帧敌人与塔的数量在暴力扫描、均匀网格与四叉树之间挑选
+class TargetingIndex
+{
+public:
+    // 查询实现
+    enum Backend
+    {
+        BACKEND_BRUTE_FORCE = 0,
+        BACKEND_GRID = 1,
+        BACKEND_QUADTREE = 2
+    };
+
+    // 构造空索引
+    TargetingIndex();
+
+    // 按本帧敌人坐标重建，towerCount 为随后要发起的查询次数
+    void rebuild(const QVector<float> &x, const QVector<float> &y, int towerCount);
+    // 取出与圆心距离不超过 radius 的敌人下标，总是按下标升序，结果与所选实现无关
+    void queryCircle(float centerX, float centerY, float radius, QVector<int> *out) const;
+    // 本帧使用的实现
+    Backend activeBackend() const { return backend; }
+    // 固定使用某种实现（基准与对照用），传 -1 恢复自动挑选
+    void forceBackend(int forced) { forcedBackend = forced; }
+
+    // 按当前阈值为给定数量挑选实现
+    static Backend chooseBackend(int enemyCount, int towerCount);
+    // 在合成场景上实测各实现耗时并更新切换阈值，可在工作线程调用
+    static void calibrate();
+    // 实现名称
+    static const char *backendName(Backend backend);
+
+private:
+    // 按格子计数排序，生成每格起点与格内敌人下标
+    void buildGrid();
+    // 网格查询，命中记入 hitMask
+    void queryGrid(float centerX, float centerY, float radius) const;
+
+    Backend backend;
+    int forcedBackend;
+    QVector<float> xs;
+    QVector<float> ys;
+
+    QVector<int> cellStart;
+    QVector<int> cellItems;
+
+    // 元素为敌人下标，查询结果同样按下标升序
+    SpatialIndex<int> tree;
+
+    // 网格查询时的命中位图，每位对应一个敌人下标
+    mutable QVector<quint32> hitMask;
+};
+
+#endif // TARGETINGINDEX_H
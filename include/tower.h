@@ -2,14 +2,15 @@
 #define TOWER_H
 
 #include "gameentity.h"
-#include <QTimer>
+#include "bullet.h"
 #include <QList>
 #include <QGraphicsPixmapItem>
 #include <QPointer>
-#include <QElapsedTimer>
+#include <QHash>
 
 class Enemy;
 class QGraphicsScene;
+class QDataStream;
 
 // 防御塔图元与攻击逻辑
 class Tower : public GameEntity, public ISoundPlayable
@@ -31,6 +32,8 @@ public:
 
     // 刷新塔目标与旋转
     void update() override;
+    // 按模拟时间推进攻击节拍
+    void advance(int dtMs);
     // 手动设置当前攻击目标
     void setTarget(QPointer<Enemy> target);
     // 对当前目标发射子弹
@@ -50,18 +53,15 @@ public:
     // 更新范围内可攻击敌人
     void setEnemiesInRange(const QList<QPointer<Enemy>> &enemies);
 
-    // 暂停攻击计时器
-    void pauseAttack()
-    {
-        if (attackTimer)
-            attackTimer->stop();
-    }
-    // 恢复攻击计时器
-    void resumeAttack()
-    {
-        if (attackTimer && !attackTimer->isActive())
-            attackTimer->start(fireRate);
-    }
+    // 暂停攻击节拍
+    void pauseAttack() { attackPaused = true; }
+    // 恢复攻击节拍
+    void resumeAttack() { attackPaused = false; }
+
+    // 写入存档所需的运行状态，目标敌人以下标保存
+    void saveState(QDataStream &out, const QHash<const Enemy *, int> &enemyIndex) const;
+    // 按存档重建防御塔，目标下标对应 enemies 列表
+    static Tower *restoreState(QDataStream &in, const QList<QPointer<Enemy>> &enemies, QObject *parent = nullptr);
 
     // 获取底座图形项指针
     QGraphicsPixmapItem *getBaseItem() const { return baseItem; }
@@ -71,12 +71,11 @@ public:
     // 播放塔相关音效
     void playSound(const QString &soundId, qreal volume = 1.0, bool loop = false) override;
 
-private slots:
-    // 攻击计时器回调入口
-    void onAttackTimer();
 signals:
     // 每次成功开火发射信号
     void fired();
+    // 新建子弹交由管理器推进
+    void bulletFired(QPointer<Bullet> bullet);
     // 当前锁定目标被消灭
     void targetDestroyed();
 
@@ -87,7 +86,9 @@ private:
     int fireRate; // 毫秒
     int cost;
     QPointer<Enemy> currentTarget; // 当前攻击目标
-    QTimer *attackTimer;
+    qint64 simTimeMs;              // 塔自身累计的模拟时间
+    int attackAccumulatorMs;
+    bool attackPaused;
     QList<QPointer<Enemy>> enemiesInRange;
     QMap<Enemy*, qint64> enemyEntryTimes; // 记录敌人进入范围的时间
     qint64 targetLostTime; // 目标丢失的时间戳
@@ -98,10 +99,12 @@ private:
     qreal targetRotation;          // 目标旋转角度
     qreal rotationSpeed;           // 旋转速度
     bool targetLocked;
-    QElapsedTimer targetLockTimer;
+    qint64 targetLockedAtMs;       // 最近一次开火锁定的时间，-1 表示尚未开火
 
     ResourceManager *resourceManager;
 
+    // 攻击节拍到达时尝试开火
+    void onAttackTick();
     // 判断敌人是否在射程内
     bool isInRange(QPointer<Enemy> enemy) const;
     // 在范围内选择合适目标
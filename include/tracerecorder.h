@@ -0,0 +1,80 @@
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include "eventring.h"
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include <atomic>
+
+// 记录仿真与渲染时间线并导出 Chrome Trace JSON
+class TraceRecorder
+{
+public:
+    // 单条时间线事件（名称与分类须为静态字符串）
+    struct Event
+    {
+        const char *name;
+        const char *category;
+        qint64 timestampNs;
+        quintptr threadId;
+        char phase; // 'B' 开始, 'E' 结束, 'i' 瞬时
+    };
+
+    // 环形缓冲可保留的事件数
+    static const int CAPACITY = 1 << 16;
+
+    // 获取全局单例记录器
+    static TraceRecorder &instance();
+
+    // 记录区间开始事件
+    void begin(const char *name, const char *category);
+    // 记录区间结束事件
+    void end(const char *name, const char *category);
+    // 记录瞬时事件
+    void instant(const char *name, const char *category);
+
+    // 开启或关闭事件记录
+    void setEnabled(bool enabled) { recording.store(enabled, std::memory_order_relaxed); }
+    // 查询是否正在记录
+    bool isEnabled() const { return recording.load(std::memory_order_relaxed); }
+    // 清空已记录的事件
+    void clear() { events.clear(); }
+
+    // 生成 Chrome Trace Event JSON
+    QByteArray toChromeTraceJson() const;
+    // 将时间线写入指定文件
+    bool writeChromeTrace(const QString &filePath) const;
+
+private:
+    // 私有构造仅供单例使用
+    TraceRecorder();
+
+    // 写入一条事件
+    void record(const char *name, const char *category, char phase);
+
+    EventRing<Event, CAPACITY> events;
+    QElapsedTimer clock;
+    std::atomic<bool> recording;
+};
+
+// 在作用域内记录一对开始/结束事件
+class TraceScope
+{
+public:
+    TraceScope(const char *name, const char *category)
+        : name(name), category(category)
+    {
+        TraceRecorder::instance().begin(name, category);
+    }
+    ~TraceScope()
+    {
+        TraceRecorder::instance().end(name, category);
+    }
+
+private:
+    const char *name;
+    const char *category;
+};
+
+#endif // TRACERECORDER_H
@@ -0,0 +1,418 @@
+#include "include/audiomixer.h"
+
+#include <QAudioFormat>
+#include <QFile>
+#include <QDebug>
+#include <QThread>
+#include <QtEndian>
+#include <cstring>
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QAudioSink>
+#include <QMediaDevices>
+#else
+#include <QAudioOutput>
+#endif
+
+namespace
+{
+    const int UNITY_GAIN = 256;
+    // 合并音效允许超过原始音量，混音时仍会饱和截断
+    const int MAX_GAIN = UNITY_GAIN * 2;
+
+    QAudioFormat mixerFormat()
+    {
+        QAudioFormat format;
+        format.setSampleRate(GameConfig::AUDIO_SAMPLE_RATE);
+        format.setChannelCount(1);
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        format.setSampleFormat(QAudioFormat::Int16);
+#else
+        format.setSampleSize(16);
+        format.setSampleType(QAudioFormat::SignedInt);
+        format.setByteOrder(QAudioFormat::LittleEndian);
+        format.setCodec("audio/pcm");
+#endif
+        return format;
+    }
+}
+
+AudioMixer::AudioMixer(QObject *parent)
+    : QIODevice(parent),
+      activeVoices(0),
+      droppedCommands(0),
+      audioThread(nullptr),
+      outputContext(nullptr),
+      sink(nullptr)
+{
+    for (Voice &voice : voices)
+    {
+        voice.clip = nullptr;
+        voice.position = 0;
+        voice.gain = 0;
+        voice.priority = 0;
+        voice.loop = false;
+        voice.active = false;
+    }
+    clock.start();
+}
+
+AudioMixer::~AudioMixer()
+{
+    stop();
+    qDeleteAll(clips);
+}
+
+bool AudioMixer::loadClip(const QString &soundId, const QString &filePath, int priority, int minIntervalMs)
+{
+    QVector<qint16> samples;
+    if (!decodeWavFile(filePath, &samples))
+        return false;
+    return addClip(soundId, samples, priority, minIntervalMs);
+}
+
+bool AudioMixer::addClip(const QString &soundId, const QVector<qint16> &samples, int priority, int minIntervalMs)
+{
+    // 音频线程运行期间音效表只读
+    if (audioThread)
+    {
+        qWarning() << "[Audio] addClip called while running, ignored" << soundId;
+        return false;
+    }
+
+    Clip *clip = new Clip;
+    clip->samples = samples;
+    clip->priority = priority;
+    clip->minIntervalMs = minIntervalMs;
+    clip->lastPlayedMs = -minIntervalMs;
+
+    Clip *previous = clips.value(soundId, nullptr);
+    if (previous)
+    {
+        // 替换前停掉仍在引用旧数据的音轨
+        for (Voice &voice : voices)
+        {
+            if (voice.clip == previous)
+                voice.active = false;
+        }
+        delete previous;
+    }
+    clips.insert(soundId, clip);
+    return true;
+}
+
+bool AudioMixer::decodeWavFile(const QString &filePath, QVector<qint16> *samples)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "[Audio] Cannot open" << filePath;
+        return false;
+    }
+
+    if (!decodeWav(file.readAll(), samples))
+    {
+        qWarning() << "[Audio] Unsupported WAV format" << filePath;
+        return false;
+    }
+    return true;
+}
+
+bool AudioMixer::decodeWav(const QByteArray &bytes, QVector<qint16> *samples)
+{
+    const char *data = bytes.constData();
+    const int size = bytes.size();
+    if (size < 12 || std::memcmp(data, "RIFF", 4) != 0 || std::memcmp(data + 8, "WAVE", 4) != 0)
+        return false;
+
+    int channels = 0;
+    int sampleRate = 0;
+    int bitsPerSample = 0;
+    int format = 0;
+    const char *pcm = nullptr;
+    int pcmBytes = 0;
+
+    // 逐块扫描，只关心 fmt 与 data
+    int offset = 12;
+    while (offset + 8 <= size)
+    {
+        const char *chunk = data + offset;
+        quint32 chunkSize = qFromLittleEndian<quint32>(reinterpret_cast<const uchar *>(chunk + 4));
+        const char *body = chunk + 8;
+        qint64 available = size - (offset + 8);
+        if (chunkSize > available)
+            chunkSize = static_cast<quint32>(available);
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16)
+        {
+            format = qFromLittleEndian<quint16>(reinterpret_cast<const uchar *>(body));
+            channels = qFromLittleEndian<quint16>(reinterpret_cast<const uchar *>(body + 2));
+            sampleRate = static_cast<int>(qFromLittleEndian<quint32>(reinterpret_cast<const uchar *>(body + 4)));
+            bitsPerSample = qFromLittleEndian<quint16>(reinterpret_cast<const uchar *>(body + 14));
+        }
+        else if (std::memcmp(chunk, "data", 4) == 0)
+        {
+            pcm = body;
+            pcmBytes = static_cast<int>(chunkSize);
+        }
+
+        offset += 8 + static_cast<int>(chunkSize) + (chunkSize & 1);
+    }
+
+    // 资源中的音效统一为 16 位 PCM，采样率需与输出一致
+    if (format != 1 || bitsPerSample != 16 || channels < 1 || channels > 2 ||
+        sampleRate != GameConfig::AUDIO_SAMPLE_RATE || !pcm)
+        return false;
+
+    int frames = pcmBytes / (2 * channels);
+    samples->resize(frames);
+    const uchar *src = reinterpret_cast<const uchar *>(pcm);
+    for (int i = 0; i < frames; ++i)
+    {
+        if (channels == 1)
+        {
+            (*samples)[i] = qFromLittleEndian<qint16>(src + i * 2);
+        }
+        else
+        {
+            int left = qFromLittleEndian<qint16>(src + i * 4);
+            int right = qFromLittleEndian<qint16>(src + i * 4 + 2);
+            (*samples)[i] = static_cast<qint16>((left + right) / 2);
+        }
+    }
+    return true;
+}
+
+void AudioMixer::start()
+{
+    if (audioThread)
+        return;
+
+    open(QIODevice::ReadOnly);
+
+    audioThread = new QThread;
+    audioThread->setObjectName(QStringLiteral("AudioMixer"));
+    outputContext = new QObject;
+    outputContext->moveToThread(audioThread);
+    audioThread->start();
+
+    // 输出设备在音频线程创建，拉取与混音都发生在该线程的事件循环里
+    QMetaObject::invokeMethod(outputContext, [this]() {
+        QAudioFormat format = mixerFormat();
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        sink = new QAudioSink(QMediaDevices::defaultAudioOutput(), format);
+#else
+        sink = new QAudioOutput(format);
+#endif
+        int bytesPerMs = GameConfig::AUDIO_SAMPLE_RATE * 2 / 1000;
+        sink->setBufferSize(bytesPerMs * GameConfig::AUDIO_BUFFER_MS);
+        sink->start(this);
+    }, Qt::QueuedConnection);
+}
+
+void AudioMixer::stop()
+{
+    if (!audioThread)
+        return;
+
+    QMetaObject::invokeMethod(outputContext, [this]() {
+        if (sink)
+        {
+            sink->stop();
+            delete sink;
+            sink = nullptr;
+        }
+    }, Qt::BlockingQueuedConnection);
+
+    audioThread->quit();
+    audioThread->wait();
+    delete outputContext;
+    outputContext = nullptr;
+    delete audioThread;
+    audioThread = nullptr;
+    close();
+
+    // 线程已结束，丢弃残留命令与音轨
+    Command command;
+    while (commands.tryPop(&command))
+    {
+    }
+    for (Voice &voice : voices)
+        voice.active = false;
+    activeVoices.store(0, std::memory_order_relaxed);
+}
+
+bool AudioMixer::play(const QString &soundId, qreal volume, bool loop)
+{
+    Clip *clip = clips.value(soundId, nullptr);
+    if (!clip || clip->samples.isEmpty())
+        return false;
+
+    // 同一音效在限频间隔内只发声一次
+    qint64 now = clock.elapsed();
+    if (now - clip->lastPlayedMs < clip->minIntervalMs)
+        return false;
+
+    Command command;
+    command.type = Command::COMMAND_PLAY;
+    command.clip = clip;
+    command.gain = qBound(0, static_cast<int>(volume * UNITY_GAIN), MAX_GAIN);
+    command.loop = loop;
+    if (!commands.tryPush(command))
+    {
+        // 音频线程跟不上时宁可丢音效，也不阻塞游戏线程
+        droppedCommands.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    clip->lastPlayedMs = now;
+    return true;
+}
+
+int AudioMixer::pickVoice(int priority) const
+{
+    int candidate = -1;
+    for (int i = 0; i < GameConfig::AUDIO_MAX_VOICES; ++i)
+    {
+        const Voice &voice = voices[i];
+        if (!voice.active)
+            return i;
+
+        // 只抢占优先级不高于新音效的音轨，优先抢优先级最低、播放进度最靠后的
+        if (voice.priority > priority || voice.loop)
+            continue;
+        if (candidate < 0)
+        {
+            candidate = i;
+            continue;
+        }
+        const Voice &best = voices[candidate];
+        if (voice.priority < best.priority ||
+            (voice.priority == best.priority &&
+             voice.position * static_cast<qint64>(best.clip->samples.size()) >
+                 best.position * static_cast<qint64>(voice.clip->samples.size())))
+        {
+            candidate = i;
+        }
+    }
+    return candidate;
+}
+
+void AudioMixer::stopAll()
+{
+    Command command;
+    command.type = Command::COMMAND_STOP_ALL;
+    command.clip = nullptr;
+    command.gain = 0;
+    command.loop = false;
+    if (!commands.tryPush(command))
+        droppedCommands.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AudioMixer::drainCommands()
+{
+    Command command;
+    while (commands.tryPop(&command))
+    {
+        if (command.type == Command::COMMAND_STOP_ALL)
+        {
+            for (Voice &voice : voices)
+                voice.active = false;
+            continue;
+        }
+
+        int index = pickVoice(command.clip->priority);
+        if (index < 0)
+            continue;
+
+        Voice &voice = voices[index];
+        voice.clip = command.clip;
+        voice.position = 0;
+        voice.gain = command.gain;
+        voice.priority = command.clip->priority;
+        voice.loop = command.loop;
+        voice.active = true;
+    }
+}
+
+qint64 AudioMixer::bytesAvailable() const
+{
+    // 持续输出（空闲时为静音），让输出端始终按缓冲大小拉取
+    return GameConfig::AUDIO_SAMPLE_RATE * 2 + QIODevice::bytesAvailable();
+}
+
+qint64 AudioMixer::readData(char *data, qint64 maxlen)
+{
+    int frames = static_cast<int>(maxlen / 2);
+    if (frames <= 0)
+        return 0;
+
+    drainCommands();
+    mixInto(reinterpret_cast<qint16 *>(data), frames);
+    return static_cast<qint64>(frames) * 2;
+}
+
+void AudioMixer::mixInto(qint16 *out, int frames)
+{
+    bool anyActive = false;
+    for (const Voice &voice : voices)
+        anyActive = anyActive || voice.active;
+    if (!anyActive)
+    {
+        activeVoices.store(0, std::memory_order_relaxed);
+        std::memset(out, 0, static_cast<size_t>(frames) * sizeof(qint16));
+        return;
+    }
+
+    if (mixBuffer.size() < frames)
+        mixBuffer.resize(frames);
+    qint32 *acc = mixBuffer.data();
+    std::memset(acc, 0, static_cast<size_t>(frames) * sizeof(qint32));
+
+    for (Voice &voice : voices)
+    {
+        if (!voice.active)
+            continue;
+
+        const qint16 *src = voice.clip->samples.constData();
+        const int length = voice.clip->samples.size();
+        int written = 0;
+        while (written < frames)
+        {
+            int count = qMin(frames - written, length - voice.position);
+            const qint16 *from = src + voice.position;
+            for (int i = 0; i < count; ++i)
+                acc[written + i] += (from[i] * voice.gain) >> 8;
+            written += count;
+            voice.position += count;
+
+            if (voice.position >= length)
+            {
+                if (!voice.loop)
+                {
+                    voice.active = false;
+                    break;
+                }
+                voice.position = 0;
+            }
+        }
+    }
+
+    for (int i = 0; i < frames; ++i)
+        out[i] = static_cast<qint16>(qBound(-32768, acc[i], 32767));
+
+    int stillActive = 0;
+    for (const Voice &voice : voices)
+    {
+        if (voice.active)
+            stillActive++;
+    }
+    activeVoices.store(stillActive, std::memory_order_relaxed);
+}
+
+qint64 AudioMixer::writeData(const char *data, qint64 len)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(len);
+    return -1;
+}
@@ -2,17 +2,18 @@
 #include "include/enemy.h"
 #include "include/config.h"
 #include "include/resourcemanager.h"
+#include "include/tracerecorder.h"
+#include "include/logger.h"
+#include "include/fastmath.h"
 
 #include <QPainter>
 #include <QBrush>
 #include <QPen>
 #include <QGraphicsScene>
+#include <QDataStream>
 #include <cmath>
-#include <QDebug>
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
+int Bullet::liveCount = 0;
 
 Bullet::Bullet(BulletType type, QPointF startPos, const QPointF &initialDirection, QPointer<Enemy> target, int damage, QObject *parent)
     : GameEntity(BULLET, parent)
@@ -20,12 +21,21 @@ Bullet::Bullet(BulletType type, QPointF startPos, const QPointF &initialDirectio
     , target(target)
     , damage(damage)
     , speed(GameConfig::BULLET_SPEED)
+    , moveAccumulatorMs(0)
+    , movementPaused(false)
+    , finished(false)
     , direction(0.0, -1.0)
     , startPosition(startPos)
     , travelledDistance(0.0f)
     , lostTargetTimeMs(0)
+    , analytic(false)
+    , launchPosition(startPos)
+    , flightMs(0)
+    , flightElapsedMs(0)
     , resourceManager(nullptr)
 {
+    liveCount++;
+
     // 设置子弹位置为传入的中心点坐标
     setPos(startPos);
 
@@ -61,122 +71,271 @@ Bullet::Bullet(BulletType type, QPointF startPos, const QPointF &initialDirectio
 
     updateRotation();
 
-    moveTimer = new QTimer(this);
-    connect(moveTimer, &QTimer::timeout, this, &Bullet::onMoveTimer);
-    moveTimer->start(GameConfig::BULLET_MOVE_INTERVAL);
+    LOG_DEBUG(CATEGORY_BULLET, "Bullet created at (%1, %2) direction (%3, %4) hasTarget %5",
+              startPos.x(), startPos.y(), direction.x(), direction.y(), target ? 1 : 0);
+}
+
+void Bullet::saveState(QDataStream &out, const QHash<const Enemy *, int> &enemyIndex) const
+{
+    out << static_cast<qint8>(bulletType)
+        << x() << y()
+        << direction.x() << direction.y()
+        << startPosition.x() << startPosition.y()
+        << static_cast<qint16>(enemyIndex.value(target.data(), -1))
+        << static_cast<qint32>(damage)
+        << speed
+        << static_cast<qint16>(moveAccumulatorMs)
+        << travelledDistance
+        << static_cast<qint32>(lostTargetTimeMs)
+        << static_cast<qint8>(analytic ? 1 : 0)
+        << launchPosition.x() << launchPosition.y()
+        << static_cast<qint32>(flightMs)
+        << static_cast<qint32>(flightElapsedMs);
+}
+
+Bullet *Bullet::restoreState(QDataStream &in, const QList<QPointer<Enemy>> &enemies, QObject *parent)
+{
+    qint8 type = 0;
+    qreal posX = 0;
+    qreal posY = 0;
+    qreal dirX = 0;
+    qreal dirY = 0;
+    qreal startX = 0;
+    qreal startY = 0;
+    qint16 targetIndex = -1;
+    qint32 savedDamage = 0;
+    float savedSpeed = 0;
+    qint16 accumulator = 0;
+    float travelled = 0;
+    qint32 lostTime = 0;
+    qint8 savedAnalytic = 0;
+    qreal launchX = 0;
+    qreal launchY = 0;
+    qint32 savedFlight = 0;
+    qint32 savedElapsed = 0;
+    in >> type >> posX >> posY >> dirX >> dirY >> startX >> startY
+       >> targetIndex >> savedDamage >> savedSpeed >> accumulator >> travelled >> lostTime
+       >> savedAnalytic >> launchX >> launchY >> savedFlight >> savedElapsed;
+    if (in.status() != QDataStream::Ok || type < BULLET_ARROW || type > BULLET_MAGIC)
+        return nullptr;
 
-    qDebug() << "Bullet created at" << startPos
-             << "direction" << direction
-             << "target" << (target ? "valid" : "invalid");
+    Bullet *bullet = new Bullet(static_cast<BulletType>(type), QPointF(posX, posY), QPointF(dirX, dirY),
+                                enemies.value(targetIndex), savedDamage, parent);
+    bullet->startPosition = QPointF(startX, startY);
+    bullet->speed = savedSpeed;
+    bullet->moveAccumulatorMs = accumulator;
+    bullet->travelledDistance = travelled;
+    bullet->lostTargetTimeMs = lostTime;
+    // 目标下标失效时按逐步模拟恢复，advanceFlight 也会这样处理
+    bullet->analytic = savedAnalytic != 0 && bullet->target;
+    bullet->launchPosition = QPointF(launchX, launchY);
+    bullet->flightMs = savedFlight;
+    bullet->flightElapsedMs = savedElapsed;
+    return bullet;
 }
 
 Bullet::~Bullet()
 {
-    if (moveTimer) {
-        moveTimer->stop();
-    }
+    liveCount--;
 }
 
 void Bullet::update()
 {
-    onMoveTimer();
+    step();
 }
 
-void Bullet::onMoveTimer()
+void Bullet::advance(int dtMs)
 {
-    QPointF currentPos = pos();
-    bool hasTarget = target && !target.isNull();
+    if (analytic)
+    {
+        advanceFlight(dtMs);
+        return;
+    }
+
+    for (int steps = takeMoveSteps(dtMs); steps > 0 && !finished; --steps)
+        step();
+}
 
-    if (!hasTarget)
+int Bullet::takeMoveSteps(int dtMs)
+{
+    if (movementPaused || finished)
+        return 0;
+
+    // 原移动计时器的节拍改由模拟时间累加驱动
+    moveAccumulatorMs += dtMs;
+    int steps = moveAccumulatorMs / GameConfig::BULLET_MOVE_INTERVAL;
+    moveAccumulatorMs -= steps * GameConfig::BULLET_MOVE_INTERVAL;
+    return steps;
+}
+
+bool Bullet::planIntercept(int tickMs)
+{
+    if (!GameConfig::BULLET_ANALYTIC_IMPACT || analytic || finished || tickMs <= 0)
+        return false;
+    if (!target || !target->isOnLanePath() || target->isAtEnd())
+        return false;
+
+    // 子弹在开火当帧就走第一次节拍，第 k 次推进时敌人已多走了 k - 1 帧；
+    // 直线飞行 k 帧累计 speed * floor(k * tickMs / 间隔)，取第一帧能够着预测中心的
+    const QPointF start = pos();
+    const qreal hitRadius = GameConfig::ENEMY_COLLISION_RADIUS + GameConfig::BULLET_COLLISION_RADIUS;
+    const float pathLength = target->getPathLength();
+    for (int ticks = 1; ; ++ticks)
     {
-        lostTargetTimeMs += GameConfig::BULLET_MOVE_INTERVAL;
-        if (lostTargetTimeMs >= GameConfig::BULLET_TARGET_LOST_TIMEOUT_MS)
+        const qreal reach = speed * ((moveAccumulatorMs + ticks * tickMs) / GameConfig::BULLET_MOVE_INTERVAL);
+        if (reach > GameConfig::BULLET_MAX_DISTANCE)
+            return false;
+        // 追上之前目标已走到终点，交给逐步模拟
+        if (target->predictProgress(ticks - 1, tickMs) >= pathLength)
+            return false;
+
+        const QPointF toAim = target->predictCenter(ticks - 1, tickMs) - start;
+        const qreal distanceSq = toAim.x() * toAim.x() + toAim.y() * toAim.y();
+        if (distanceSq > (reach + hitRadius) * (reach + hitRadius))
+            continue;
+
+        analytic = true;
+        launchPosition = start;
+        flightMs = ticks * tickMs;
+        flightElapsedMs = 0;
+        if (distanceSq > 0.0)
         {
-            if (scene())
-                scene()->removeItem(this);
-            deleteLater();
-            return;
+            direction = toAim * FastMath::rsqrt(distanceSq);
+            updateRotation();
         }
+        return true;
+    }
+}
+
+void Bullet::advanceFlight(int dtMs)
+{
+    if (movementPaused || finished)
+        return;
+
+    // 目标在落点前消失或已被别的子弹打死：从当前位置沿当前方向转回逐步模拟，照常计入已飞距离
+    if (!target || target->getHealth() <= 0)
+    {
+        target = nullptr;
+        analytic = false;
+        QPointF flown = pos() - launchPosition;
+        travelledDistance = std::sqrt(flown.x() * flown.x() + flown.y() * flown.y());
+        return;
     }
 
+    flightElapsedMs += dtMs;
+    if (flightElapsedMs >= flightMs)
+    {
+        hitTarget();
+        return;
+    }
+
+    // 显示位置从发射点朝目标当前中心按飞行进度插值，到点时正好落在目标上
+    const qreal fraction = static_cast<qreal>(flightElapsedMs) / flightMs;
+    const QPointF nextPos = launchPosition + (target->getCenterPosition() - launchPosition) * fraction;
+    const QPointF delta = nextPos - pos();
+    const qreal deltaSq = delta.x() * delta.x() + delta.y() * delta.y();
+    if (deltaSq > 0.0)
+    {
+        direction = delta * FastMath::rsqrt(deltaSq);
+        updateRotation();
+    }
+    setPos(nextPos);
+}
+
+void Bullet::finish()
+{
+    finished = true;
+    if (scene())
+        scene()->removeItem(this);
+    deleteLater();
+}
+
+void Bullet::step()
+{
+    if (finished)
+        return;
+
+    QPointF currentPos = pos();
+    bool hasTarget = target && !target.isNull();
+
+    if (!hasTarget && expireLostTarget())
+        return;
+
+    const qreal hitRadius = GameConfig::ENEMY_COLLISION_RADIUS + GameConfig::BULLET_COLLISION_RADIUS;
+    QPointF newDirection = direction;
     if (hasTarget)
     {
         QPointF targetCenter = target->getCenterPosition();
         QPointF toTarget = targetCenter - currentPos;
         qreal distanceToTarget = std::sqrt(toTarget.x() * toTarget.x() + toTarget.y() * toTarget.y());
-        if (distanceToTarget <= GameConfig::ENEMY_COLLISION_RADIUS + GameConfig::BULLET_COLLISION_RADIUS)
+        if (distanceToTarget <= hitRadius)
         {
-            qDebug() << "Bullet hit target! Dealing" << damage << "damage";
-            emit hit(target, damage);
-            target->setHealth(target->getHealth() - damage);
-            playSound("hurt", 0.8, false);
-            if (scene())
-                scene()->removeItem(this);
-            deleteLater();
+            hitTarget();
             return;
         }
 
         if (distanceToTarget > 0.0)
         {
-            QPointF desiredDir = toTarget / distanceToTarget;
-
-            QPointF dir = direction;
-            qreal dirLen = std::sqrt(dir.x() * dir.x() + dir.y() * dir.y());
-            if (dirLen > 0.0)
-                dir /= dirLen;
-
-            qreal dot = dir.x() * desiredDir.x() + dir.y() * desiredDir.y();
-
-            // 优化：如果角度大于 90 度（dot < 0），则停止跟踪，否则转弯会过急
-            if (dot < 0)
-            {
-                // 停止追踪，直线飞行
-                target = nullptr;
-                hasTarget = false;
-            }
-            else
-            {
-                if (dot > 1.0) dot = 1.0;
-                
-                qreal angle = std::acos(dot);
-                qreal maxTurnDeg = 15.0; // 增加最大转弯角度
-                qreal maxTurnRad = maxTurnDeg * M_PI / 180.0;
-
-                if (angle > 0.0001)
-                {
-                    qreal turn = angle;
-                    if (turn > maxTurnRad)
-                        turn = maxTurnRad;
-
-                    qreal cross = dir.x() * desiredDir.y() - dir.y() * desiredDir.x();
-                    qreal sign = cross >= 0.0 ? 1.0 : -1.0;
-
-                    qreal c = std::cos(turn);
-                    qreal s = std::sin(turn) * sign;
-
-                    QPointF newDir(dir.x() * c - dir.y() * s,
-                                   dir.x() * s + dir.y() * c);
-
-                    qreal newLen = std::sqrt(newDir.x() * newDir.x() + newDir.y() * newDir.y());
-                    if (newLen > 0.0)
-                        direction = newDir / newLen;
-                }
-            }
+            qreal maxTurnRad = GameConfig::BULLET_MAX_TURN_DEG * FastMath::DEG_TO_RAD;
+            // 停止追踪，直线飞行
+            hasTarget = steerTowards(direction, toTarget, maxTurnRad, &newDirection);
         }
     }
 
-    QPointF delta = direction * speed;
-    QPointF nextPos = currentPos + delta;
+    // 按整段位移做扫掠检测，单步走得再远也不会穿过目标
+    QPointF nextPos = currentPos + newDirection * speed;
+    qreal contactTime = 0.0;
+    if (target && sweepCircle(currentPos, nextPos, target->getCenterPosition(), hitRadius, &contactTime))
+    {
+        hitTarget();
+        return;
+    }
+
+    applyStep(nextPos, newDirection, hasTarget);
+}
+
+bool Bullet::expireLostTarget()
+{
+    lostTargetTimeMs += GameConfig::BULLET_MOVE_INTERVAL;
+    if (lostTargetTimeMs < GameConfig::BULLET_TARGET_LOST_TIMEOUT_MS)
+        return false;
+
+    finish();
+    return true;
+}
+
+void Bullet::hitTarget()
+{
+    hitEnemy(target);
+}
+
+void Bullet::hitEnemy(Enemy *enemy)
+{
+    if (!enemy)
+        return;
+
+    LOG_DEBUG(CATEGORY_BULLET, "Bullet hit enemy, dealing %1 damage (target %2)", damage, enemy == target ? 1 : 0);
+    TraceRecorder::instance().instant("bulletHit", "sim");
+    emit hit(enemy, damage);
+    enemy->setHealth(enemy->getHealth() - damage);
+    playSound("hurt", 0.8, false);
+    finish();
+}
+
+void Bullet::applyStep(const QPointF &nextPos, const QPointF &newDirection, bool tracking)
+{
+    direction = newDirection;
+    if (!tracking)
+        target = nullptr;
     setPos(nextPos);
 
     updateRotation();
 
-    travelledDistance += std::sqrt(delta.x() * delta.x() + delta.y() * delta.y());
+    // 方向始终是单位向量，每步恰好飞行 speed
+    travelledDistance += speed;
     if (travelledDistance >= GameConfig::BULLET_MAX_DISTANCE)
     {
-        if (scene())
-            scene()->removeItem(this);
-        deleteLater();
+        finish();
         return;
     }
 
@@ -185,13 +344,79 @@ void Bullet::onMoveTimer()
         nextPos.y() < -GameConfig::BULLET_SIZE ||
         nextPos.y() > GameConfig::WINDOW_HEIGHT + GameConfig::BULLET_SIZE)
     {
-        if (scene())
-            scene()->removeItem(this);
-        deleteLater();
+        finish();
         return;
     }
 }
 
+bool Bullet::steerTowards(const QPointF &currentDir, const QPointF &toTarget, qreal maxTurnRad, QPointF *newDir)
+{
+    qreal distanceSq = toTarget.x() * toTarget.x() + toTarget.y() * toTarget.y();
+    if (distanceSq <= 0.0)
+        return true;
+
+    QPointF desiredDir = toTarget * FastMath::rsqrt(distanceSq);
+
+    QPointF dir = currentDir;
+    qreal dirLenSq = dir.x() * dir.x() + dir.y() * dir.y();
+    if (dirLenSq > 0.0)
+        dir *= FastMath::rsqrt(dirLenSq);
+
+    qreal dot = dir.x() * desiredDir.x() + dir.y() * desiredDir.y();
+
+    // 优化：如果角度大于 90 度（dot < 0），则停止跟踪，否则转弯会过急
+    if (dot < 0)
+        return false;
+
+    // 与最大转角的余弦比较代替 acos：偏角不超过最大转角就直接对准
+    float sinTurn = 0.0f;
+    float cosTurn = 1.0f;
+    FastMath::sincos(maxTurnRad, &sinTurn, &cosTurn);
+    if (dot >= cosTurn)
+    {
+        *newDir = desiredDir;
+        return true;
+    }
+
+    qreal cross = dir.x() * desiredDir.y() - dir.y() * desiredDir.x();
+    qreal s = cross >= 0.0 ? sinTurn : -sinTurn;
+
+    QPointF rotated(dir.x() * cosTurn - dir.y() * s,
+                    dir.x() * s + dir.y() * cosTurn);
+    *newDir = rotated * FastMath::rsqrt(rotated.x() * rotated.x() + rotated.y() * rotated.y());
+    return true;
+}
+
+bool Bullet::sweepCircle(const QPointF &from, const QPointF &to, const QPointF &center, qreal radius, qreal *time)
+{
+    // |offset + t * delta| = radius 的较小根即首次接触时刻
+    QPointF offset = from - center;
+    qreal c = offset.x() * offset.x() + offset.y() * offset.y() - radius * radius;
+    if (c <= 0.0)
+    {
+        *time = 0.0;
+        return true;
+    }
+
+    QPointF delta = to - from;
+    qreal a = delta.x() * delta.x() + delta.y() * delta.y();
+    qreal b = offset.x() * delta.x() + offset.y() * delta.y();
+    // 原地不动或正在远离圆心
+    if (a <= 0.0 || b >= 0.0)
+        return false;
+
+    qreal discriminant = b * b - a * c;
+    if (discriminant < 0.0)
+        return false;
+
+    qreal t = (-b - std::sqrt(discriminant)) / a;
+    if (t > 1.0)
+        return false;
+
+    *time = t;
+    return true;
+}
+
 void Bullet::playSound(const QString &soundId, qreal volume, bool loop)
 {
     if (!resourceManager)
@@ -201,8 +426,7 @@ void Bullet::playSound(const QString &soundId, qreal volume, bool loop)
 
 void Bullet::updateRotation()
 {
-    QPointF dir = direction;
-    qreal angle = std::atan2(dir.y(), dir.x()) * 180.0 / M_PI;
+    qreal angle = FastMath::atan2Degrees(direction.y(), direction.x());
     angle += 90.0;
     setRotation(angle);
 }
@@ -0,0 +1,121 @@
+#include "include/cutcellindex.h"
+#include "include/flowfield.h"
+
+#include <QtGlobal>
+
+CutCellIndex::CutCellIndex()
+    : cols(0),
+      rowCount(0),
+      root(-1)
+{
+}
+
+void CutCellIndex::rebuild(const FlowField &field, const QVector<QPoint> &goalCells)
+{
+    cols = field.columns();
+    rowCount = field.rows();
+    const int count = cols * rowCount;
+    root = count;
+    enter.fill(-1, count + 1);
+    leave.fill(-1, count + 1);
+    low.fill(0, count + 1);
+    parent.fill(-1, count + 1);
+
+    // 多个终点挂在同一个虚拟根下，“走到任一终点”就变成了“连到根”
+    QVector<int> goals;
+    for (const QPoint &cell : goalCells)
+    {
+        if (contains(cell) && field.isWalkable(cell.x(), cell.y()))
+            goals.append(index(cell));
+    }
+    QVector<quint8> isGoal(count, 0);
+    for (int goal : goals)
+        isGoal[goal] = 1;
+
+    // 显式栈的深度优先遍历，大网格下也不会爆调用栈；
+    // nextNeighbour 记录每个格子下一次要看的邻居：0~3 为四邻格，4 为虚拟根
+    QVector<int> stack;
+    QVector<int> nextNeighbour(count + 1, 0);
+    stack.reserve(count + 1);
+    stack.append(root);
+    int clock = 0;
+    enter[root] = low[root] = clock++;
+
+    static const int dx[4] = {-1, 1, 0, 0};
+    static const int dy[4] = {0, 0, -1, 1};
+    while (!stack.isEmpty())
+    {
+        int u = stack.last();
+        int v = -1;
+        if (u == root)
+        {
+            if (nextNeighbour[u] < goals.size())
+                v = goals[nextNeighbour[u]++];
+        }
+        else if (nextNeighbour[u] < 5)
+        {
+            int dir = nextNeighbour[u]++;
+            if (dir == 4)
+            {
+                if (!isGoal[u])
+                    continue;
+                v = root;
+            }
+            else
+            {
+                int x = u % cols + dx[dir];
+                int y = u / cols + dy[dir];
+                if (!field.isWalkable(x, y))
+                    continue;
+                v = y * cols + x;
+            }
+        }
+
+        if (v >= 0)
+        {
+            if (enter[v] < 0)
+            {
+                parent[v] = u;
+                enter[v] = low[v] = clock++;
+                stack.append(v);
+            }
+            else if (v != parent[u])
+            {
+                low[u] = qMin(low[u], enter[v]);
+            }
+            continue;
+        }
+
+        stack.removeLast();
+        leave[u] = clock - 1;
+        if (parent[u] >= 0)
+            low[parent[u]] = qMin(low[parent[u]], low[u]);
+    }
+}
+
+bool CutCellIndex::separates(const QPoint &blockCell, const QPoint &cell) const
+{
+    if (!contains(blockCell) || !contains(cell) || blockCell == cell)
+        return false;
+
+    int c = index(blockCell);
+    int target = index(cell);
+    if (enter[c] < 0 || enter[target] < 0)
+        return false;
+
+    // 目标落在 c 的某个子树里，且该子树绕不过 c 回到上方，则堵住 c 就断开了
+    static const int dx[4] = {-1, 1, 0, 0};
+    static const int dy[4] = {0, 0, -1, 1};
+    for (int dir = 0; dir < 4; ++dir)
+    {
+        QPoint next(blockCell.x() + dx[dir], blockCell.y() + dy[dir]);
+        if (!contains(next))
+            continue;
+        int v = index(next);
+        if (parent[v] != c)
+            continue;
+        if (enter[v] <= enter[target] && enter[target] <= leave[v])
+            return low[v] >= enter[c];
+    }
+    return false;
+}
@@ -1,10 +1,12 @@
 #include "include/enemy.h"
 #include "include/resourcemanager.h"
 #include "include/config.h"
+#include "include/flowfield.h"
 
 #include <QPainter>
 #include <QBrush>
 #include <QPen>
+#include <QDataStream>
 #include <cmath>
 
 Enemy::Enemy(int enemyType, QObject *parent)
@@ -12,7 +14,11 @@ Enemy::Enemy(int enemyType, QObject *parent)
     , enemyType(enemyType)
     , reward(GameConfig::ENEMY_REWARD)
     , speed(GameConfig::ENEMY_SPEED)
-    , currentPathIndex(0)
+    , progress(0)
+    , flowField(nullptr)
+    , lane(0)
+    , moveAccumulatorMs(0)
+    , movementPaused(false)
     , reachedEnd(false)
     , currentState(ResourceManager::ENEMY_WALK)
     , isHighlighted(false)
@@ -22,16 +28,10 @@ Enemy::Enemy(int enemyType, QObject *parent)
     // 从资源文件加载敌人图片
     ResourceManager& rm = ResourceManager::instance();
     setPixmap(rm.getEnemyPixmap(enemyType, currentState));
-
-    // 移动计时器
-    moveTimer = new QTimer(this);
-    connect(moveTimer, &QTimer::timeout, this, &Enemy::onMoveTimer);
-    moveTimer->start(GameConfig::ENEMY_MOVE_INTERVAL);
 }
 
 Enemy::~Enemy()
 {
-    moveTimer->stop();
 }
 
 void Enemy::update()
@@ -39,12 +39,13 @@ void Enemy::update()
     moveAlongPath();
 }
 
-void Enemy::setPath(const QVector<QPointF>& pathPoints)
+void Enemy::setPath(const QSharedPointer<const LanePath> &lanePath)
 {
-    this->pathPoints = pathPoints;
-    if (!pathPoints.isEmpty()) {
-        setPos(pathPoints.first());
-        currentPathIndex = 1;
+    path = lanePath;
+    progress = 0;
+    reachedEnd = false;
+    if (path && !path->isEmpty()) {
+        setPos(path->start());
     }
 }
 
@@ -55,37 +56,156 @@ QPointF Enemy::getCenterPosition() const
     return QPointF(topLeft.x() + rect.width() / 2.0, topLeft.y() + rect.height() / 2.0);
 }
 
+float Enemy::predictProgress(int ticks, int tickMs) const
+{
+    if (!path || path->isEmpty())
+        return progress;
+
+    // 暂停时节拍步数为 0，但每帧固定的一步照走
+    int steps = ticks;
+    if (!movementPaused)
+        steps += (moveAccumulatorMs + ticks * tickMs) / GameConfig::ENEMY_MOVE_INTERVAL;
+    return qMin(progress + speed * steps, static_cast<float>(path->totalLength()));
+}
+
+QPointF Enemy::predictCenter(int ticks, int tickMs) const
+{
+    if (!path || path->isEmpty())
+        return getCenterPosition();
+    return path->pointAt(predictProgress(ticks, tickMs)) + (getCenterPosition() - pos());
+}
+
 void Enemy::moveAlongPath()
 {
-    if (reachedEnd || pathPoints.isEmpty() || currentPathIndex >= pathPoints.size()) {
+    if (flowField)
+    {
+        moveAlongFlowField();
+        return;
+    }
+
+    if (reachedEnd || !path || path->isEmpty()) {
         reachedEnd = true;
         return;
     }
 
+    // 只推进弧长，拐角处剩余的步长直接带入下一段
+    setProgress(progress + speed);
+}
+
+void Enemy::setProgress(float newProgress)
+{
+    if (!path || path->isEmpty())
+        return;
+
+    const float total = static_cast<float>(path->totalLength());
+    progress = qMin(newProgress, total);
+    setPos(path->pointAt(progress));
+
+    if (progress >= total && !reachedEnd) {
+        reachedEnd = true;
+        emit reachedEndPoint();
+    }
+}
+
+void Enemy::moveAlongFlowField()
+{
+    if (reachedEnd)
+        return;
+
+    const int gridSize = GameConfig::GRID_SIZE;
+    const qreal offset = gridSize / 2 - GameConfig::ENEMY_SIZE / 2;
     QPointF currentPos = pos();
-    QPointF targetPos = pathPoints[currentPathIndex];
+    int cellX = static_cast<int>(currentPos.x() + GameConfig::ENEMY_SIZE / 2) / gridSize;
+    int cellY = static_cast<int>(currentPos.y() + GameConfig::ENEMY_SIZE / 2) / gridSize;
+
+    // 已在终点格就走向格子中心；否则走向流场给出的下一格中心。
+    // 相邻两格拼成的矩形是凸的，从本格任意位置直线过去都不会擦到别的格子
+    int targetX = cellX;
+    int targetY = cellY;
+    if (flowField->distance(cellX, cellY) != 0 &&
+        !flowField->nextCell(cellX, cellY, &targetX, &targetY))
+    {
+        // 四面被堵死，原地等待塔被拆除
+        return;
+    }
+
+    QPointF targetPos(targetX * gridSize + offset, targetY * gridSize + offset);
     QPointF direction = targetPos - currentPos;
     qreal distance = QLineF(currentPos, targetPos).length();
-
-    if (distance < speed) {
-        // 到达路径点
+    if (distance < speed)
+    {
         setPos(targetPos);
-        currentPathIndex++;
-
-        if (currentPathIndex >= pathPoints.size()) {
-            reachedEnd = true;
-            emit reachedEndPoint(); // 需要添加信号声明
-        }
-    } else {
-        // 向目标移动
-        direction /= distance;
-        setPos(currentPos + direction * speed);
+        return;
     }
+    setPos(currentPos + direction / distance * speed);
 }
 
-void Enemy::onMoveTimer()
+void Enemy::advance(int dtMs)
 {
-    moveAlongPath();
+    for (int steps = takeMoveSteps(dtMs); steps > 0; --steps)
+        moveAlongPath();
+}
+
+int Enemy::takeMoveSteps(int dtMs)
+{
+    if (movementPaused)
+        return 0;
+
+    // 原移动计时器的节拍改由模拟时间累加驱动
+    moveAccumulatorMs += dtMs;
+    int steps = moveAccumulatorMs / GameConfig::ENEMY_MOVE_INTERVAL;
+    moveAccumulatorMs -= steps * GameConfig::ENEMY_MOVE_INTERVAL;
+    return steps;
+}
+
+void Enemy::saveState(QDataStream &out) const
+{
+    out << static_cast<qint8>(enemyType)
+        << static_cast<qint8>(lane)
+        << static_cast<qint8>(currentState)
+        << x() << y()
+        << static_cast<qint32>(health)
+        << static_cast<qint32>(maxHealth)
+        << speed
+        << progress
+        << static_cast<qint16>(moveAccumulatorMs)
+        << reachedEnd;
+}
+
+Enemy *Enemy::restoreState(QDataStream &in, const QVector<QSharedPointer<const LanePath>> &lanePaths, QObject *parent)
+{
+    qint8 type = 0;
+    qint8 savedLane = 0;
+    qint8 state = 0;
+    qreal posX = 0;
+    qreal posY = 0;
+    qint32 savedHealth = 0;
+    qint32 savedMaxHealth = 0;
+    float savedSpeed = 0;
+    float savedProgress = 0;
+    qint16 accumulator = 0;
+    bool atEnd = false;
+    in >> type >> savedLane >> state >> posX >> posY >> savedHealth >> savedMaxHealth
+       >> savedSpeed >> savedProgress >> accumulator >> atEnd;
+    if (in.status() != QDataStream::Ok || savedLane < 0 || savedLane >= lanePaths.size())
+        return nullptr;
+    // 存档可能损坏：类型、状态或血量上限越界时整份存档作废，与子弹、防御塔的校验一致
+    if (type < 0 || type >= GameConfig::ENEMY_TYPE_NUMBER ||
+        state < ResourceManager::ENEMY_IDLE || state > ResourceManager::ENEMY_DEAD || savedMaxHealth <= 0)
+        return nullptr;
+
+    Enemy *enemy = new Enemy(type, parent);
+    enemy->setLane(savedLane);
+    enemy->setPath(lanePaths[savedLane]);
+    enemy->setMaxHealth(savedMaxHealth);
+    enemy->setHealth(savedHealth);
+    enemy->setSpeed(savedSpeed);
+    enemy->setPos(posX, posY);
+    enemy->progress = savedProgress;
+    enemy->moveAccumulatorMs = accumulator;
+    enemy->reachedEnd = atEnd;
+    enemy->setState(static_cast<EnemyState>(state));
+    return enemy;
 }
 
 void Enemy::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
@@ -123,9 +243,7 @@ void Enemy::setState(EnemyState state)
     
     // 敌人死亡时停止移动
     if (state == ResourceManager::ENEMY_DEAD) {
-        if (moveTimer) {
-            moveTimer->stop();
-        }
+        movementPaused = true;
     }
     
     // 根据新状态更新图片
@@ -0,0 +1,254 @@
+#include "include/flowfield.h"
+#include "include/occupancygrid.h"
+
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+const int FlowField::UNREACHABLE;
+
+FlowField::FlowField()
+    : cols(0),
+      rowCount(0),
+      markGeneration(0),
+      updatedCells(0)
+{
+}
+
+void FlowField::reset(const OccupancyGrid &grid, const QVector<QPoint> &goalCells)
+{
+    cols = grid.columns();
+    rowCount = grid.rows();
+    const int count = cols * rowCount;
+
+    dist.fill(UNREACHABLE, count);
+    walkable.fill(0, count);
+    goal.fill(0, count);
+    mark.fill(0, count);
+    markGeneration = 0;
+
+    for (int y = 0; y < rowCount; ++y)
+    {
+        for (int x = 0; x < cols; ++x)
+            walkable[index(x, y)] = grid.isWalkable(x, y) ? 1 : 0;
+    }
+
+    // 多源广度优先：所有终点同时出发
+    QVector<int> queue;
+    queue.reserve(count);
+    for (const QPoint &cell : goalCells)
+    {
+        if (!contains(cell.x(), cell.y()))
+            continue;
+        int i = index(cell.x(), cell.y());
+        goal[i] = 1;
+        if (walkable[i] && dist[i] != 0)
+        {
+            dist[i] = 0;
+            queue.append(i);
+        }
+    }
+
+    int around[4];
+    for (int head = 0; head < queue.size(); ++head)
+    {
+        int u = queue[head];
+        int n = neighbours(u, around);
+        for (int k = 0; k < n; ++k)
+        {
+            int v = around[k];
+            if (walkable[v] && dist[v] == UNREACHABLE)
+            {
+                dist[v] = dist[u] + 1;
+                queue.append(v);
+            }
+        }
+    }
+    updatedCells = queue.size();
+}
+
+bool FlowField::nextCell(int cellX, int cellY, int *nextX, int *nextY) const
+{
+    if (!contains(cellX, cellY))
+        return false;
+
+    // 当前格被新塔占住时也能借邻格脱身，所以不以自身距离为上限
+    int self = index(cellX, cellY);
+    int best = walkable[self] ? dist[self] : UNREACHABLE;
+    int bestCell = -1;
+    int around[4];
+    int n = neighbours(self, around);
+    for (int k = 0; k < n; ++k)
+    {
+        int v = around[k];
+        if (walkable[v] && dist[v] < best)
+        {
+            best = dist[v];
+            bestCell = v;
+        }
+    }
+    if (bestCell < 0)
+        return false;
+
+    *nextX = bestCell % cols;
+    *nextY = bestCell / cols;
+    return true;
+}
+
+void FlowField::blockCell(int cellX, int cellY)
+{
+    updatedCells = 0;
+    if (!contains(cellX, cellY))
+        return;
+
+    int blocked = index(cellX, cellY);
+    if (!walkable[blocked])
+        return;
+    walkable[blocked] = 0;
+    if (dist[blocked] == UNREACHABLE)
+        return;
+
+    // 第一步：找出所有最短路只能经过被挡格的格子。按层处理，
+    // 轮到某层时上一层的失效格已全部标记，是否还有别的支撑可以直接判断
+    const quint32 stamp = ++markGeneration;
+    QVector<int> affected;
+    affected.append(blocked);
+    mark[blocked] = stamp;
+
+    int around[4];
+    int support[4];
+    for (int head = 0; head < affected.size(); ++head)
+    {
+        int u = affected[head];
+        int n = neighbours(u, around);
+        for (int k = 0; k < n; ++k)
+        {
+            int v = around[k];
+            if (mark[v] == stamp || !walkable[v] || goal[v] || dist[v] != dist[u] + 1)
+                continue;
+
+            bool supported = false;
+            int m = neighbours(v, support);
+            for (int j = 0; j < m && !supported; ++j)
+            {
+                int w = support[j];
+                supported = mark[w] != stamp && walkable[w] && dist[w] == dist[v] - 1;
+            }
+            if (!supported)
+            {
+                mark[v] = stamp;
+                affected.append(v);
+            }
+        }
+    }
+
+    for (int u : affected)
+        dist[u] = UNREACHABLE;
+
+    // 第二步：从未受影响的边界格重新向受影响区域传播，区域外的距离保持不变
+    typedef std::pair<int, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    for (int u : affected)
+    {
+        if (!walkable[u])
+            continue;
+        int d = bestFromNeighbours(u);
+        if (d < UNREACHABLE)
+        {
+            dist[u] = d;
+            open.push(Entry(d, u));
+        }
+    }
+
+    while (!open.empty())
+    {
+        Entry top = open.top();
+        open.pop();
+        int u = top.second;
+        if (top.first > dist[u])
+            continue;
+
+        int n = neighbours(u, around);
+        for (int k = 0; k < n; ++k)
+        {
+            int v = around[k];
+            if (mark[v] == stamp && walkable[v] && dist[u] + 1 < dist[v])
+            {
+                dist[v] = dist[u] + 1;
+                open.push(Entry(dist[v], v));
+            }
+        }
+    }
+    updatedCells = affected.size();
+}
+
+void FlowField::unblockCell(int cellX, int cellY)
+{
+    updatedCells = 0;
+    if (!contains(cellX, cellY))
+        return;
+
+    int opened = index(cellX, cellY);
+    if (walkable[opened])
+        return;
+    walkable[opened] = 1;
+
+    int d = goal[opened] ? 0 : bestFromNeighbours(opened);
+    if (d >= UNREACHABLE)
+        return;
+    dist[opened] = d;
+
+    // 单源且边权为 1，先进先出即按距离递增，只会让距离变短
+    QVector<int> queue;
+    queue.append(opened);
+    int around[4];
+    for (int head = 0; head < queue.size(); ++head)
+    {
+        int u = queue[head];
+        int n = neighbours(u, around);
+        for (int k = 0; k < n; ++k)
+        {
+            int v = around[k];
+            if (walkable[v] && dist[u] + 1 < dist[v])
+            {
+                dist[v] = dist[u] + 1;
+                queue.append(v);
+            }
+        }
+    }
+    updatedCells = queue.size();
+}
+
+int FlowField::neighbours(int cell, int out[4]) const
+{
+    int x = cell % cols;
+    int y = cell / cols;
+    int n = 0;
+    if (x > 0)
+        out[n++] = cell - 1;
+    if (x + 1 < cols)
+        out[n++] = cell + 1;
+    if (y > 0)
+        out[n++] = cell - cols;
+    if (y + 1 < rowCount)
+        out[n++] = cell + cols;
+    return n;
+}
+
+int FlowField::bestFromNeighbours(int cell) const
+{
+    if (goal[cell])
+        return 0;
+
+    int best = UNREACHABLE;
+    int around[4];
+    int n = neighbours(cell, around);
+    for (int k = 0; k < n; ++k)
+    {
+        int v = around[k];
+        if (walkable[v] && dist[v] < UNREACHABLE && dist[v] + 1 < best)
+            best = dist[v] + 1;
+    }
+    return best;
+}
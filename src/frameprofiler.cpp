@@ -0,0 +1,387 @@
+#include "include/frameprofiler.h"
+#include "include/tracerecorder.h"
+
+#include <QStringList>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef Q_OS_WIN
+#include <malloc.h>
+#endif
+
+namespace
+{
+#ifdef TE_COUNT_ALLOCATIONS
+    // 全局堆分配计数，由下方替换的 operator new 维护
+    std::atomic<quint64> heapAllocations(0);
+
+    void *countedAlloc(std::size_t size)
+    {
+        heapAllocations.fetch_add(1, std::memory_order_relaxed);
+        return std::malloc(size ? size : 1);
+    }
+
+#if defined(__cpp_aligned_new)
+    void *countedAlignedAlloc(std::size_t size, std::align_val_t alignment)
+    {
+        heapAllocations.fetch_add(1, std::memory_order_relaxed);
+        std::size_t bytes = size ? size : 1;
+        std::size_t align = static_cast<std::size_t>(alignment);
+#ifdef Q_OS_WIN
+        return _aligned_malloc(bytes, align);
+#else
+        // posix_memalign 要求对齐至少为指针大小
+        void *ptr = nullptr;
+        if (posix_memalign(&ptr, align < sizeof(void *) ? sizeof(void *) : align, bytes) != 0)
+            return nullptr;
+        return ptr;
+#endif
+    }
+
+    void alignedFree(void *ptr)
+    {
+#ifdef Q_OS_WIN
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+#endif
+#endif
+
+    QString formatMs(qint64 nsecs)
+    {
+        return QString("%1").arg(nsecs / 1000000.0, 7, 'f', 3);
+    }
+}
+
+#ifdef TE_COUNT_ALLOCATIONS
+// 替换全局分配函数以统计每帧分配次数，仅在定义 TE_COUNT_ALLOCATIONS 的分析与基准构建中启用
+void *operator new(std::size_t size)
+{
+    void *ptr = countedAlloc(size);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void *operator new[](std::size_t size)
+{
+    void *ptr = countedAlloc(size);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAlloc(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAlloc(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+#if defined(__cpp_sized_deallocation)
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+#endif
+
+#if defined(__cpp_aligned_new)
+// 超对齐类型走单独的分配函数，同样计数，释放须与之配对
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    void *ptr = countedAlignedAlloc(size, alignment);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+    void *ptr = countedAlignedAlloc(size, alignment);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return countedAlignedAlloc(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return countedAlignedAlloc(size, alignment);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+    alignedFree(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept
+{
+    alignedFree(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    alignedFree(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    alignedFree(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept
+{
+    alignedFree(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept
+{
+    alignedFree(ptr);
+}
+#endif
+#endif
+
+FrameProfiler::FrameProfiler()
+    : frameSamples(WINDOW_SIZE, 0),
+      allocationSamples(WINDOW_SIZE, 0),
+      writeIndex(0),
+      sampleCount(0),
+      lastAllocationCount(allocationCount()),
+      enemyCount(0),
+      towerCount(0),
+      bulletCount(0),
+      levelStartMs(-1)
+{
+    for (int i = 0; i < PHASE_COUNT; ++i)
+    {
+        pendingNs[i] = 0;
+        phaseSamples[i] = QVector<qint64>(WINDOW_SIZE, 0);
+    }
+}
+
+FrameProfiler &FrameProfiler::instance()
+{
+    static FrameProfiler profiler;
+    return profiler;
+}
+
+quint64 FrameProfiler::allocationCount()
+{
+#ifdef TE_COUNT_ALLOCATIONS
+    return heapAllocations.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+bool FrameProfiler::countsAllocations()
+{
+#ifdef TE_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char *FrameProfiler::phaseName(Phase phase)
+{
+    switch (phase)
+    {
+    case PHASE_UPDATE_ENEMIES:
+        return "updateEnemies";
+    case PHASE_UPDATE_TOWERS:
+        return "updateTowers";
+    case PHASE_REMOVE_DEAD:
+        return "removeDead";
+    case PHASE_CHECK_WAVE:
+        return "checkNextWave";
+    case PHASE_BULLETS:
+        return "bullets";
+    case PHASE_PAINT:
+        return "paint";
+    default:
+        return "unknown";
+    }
+}
+
+void FrameProfiler::addPhaseTime(Phase phase, qint64 nsecs)
+{
+    if (phase < 0 || phase >= PHASE_COUNT)
+        return;
+    pendingNs[phase] += nsecs;
+}
+
+void FrameProfiler::setEntityCounts(int enemies, int towers, int bullets)
+{
+    enemyCount = enemies;
+    towerCount = towers;
+    bulletCount = bullets;
+}
+
+void FrameProfiler::endFrame()
+{
+    qint64 frameTotal = 0;
+    for (int i = 0; i < PHASE_COUNT; ++i)
+    {
+        phaseSamples[i][writeIndex] = pendingNs[i];
+        frameTotal += pendingNs[i];
+        pendingNs[i] = 0;
+    }
+    frameSamples[writeIndex] = frameTotal;
+
+    // 两次提交之间的分配都计入本帧（包含计时器回调与绘制）
+    quint64 allocations = allocationCount();
+    allocationSamples[writeIndex] = static_cast<qint64>(allocations - lastAllocationCount);
+    lastAllocationCount = allocations;
+
+    writeIndex = (writeIndex + 1) % WINDOW_SIZE;
+    if (sampleCount < WINDOW_SIZE)
+        sampleCount++;
+}
+
+FrameProfiler::Stats FrameProfiler::computeStats(const QVector<qint64> &ring) const
+{
+    Stats stats = {0, 0, 0};
+    if (sampleCount == 0)
+        return stats;
+
+    QVector<qint64> sorted = ring.mid(0, sampleCount);
+    std::sort(sorted.begin(), sorted.end());
+
+    qint64 sum = 0;
+    for (qint64 value : sorted)
+        sum += value;
+
+    int p99Index = (sampleCount * 99 + 99) / 100 - 1;
+    stats.minNs = sorted.first();
+    stats.avgNs = sum / sampleCount;
+    stats.p99Ns = sorted[qBound(0, p99Index, sampleCount - 1)];
+    return stats;
+}
+
+FrameProfiler::Stats FrameProfiler::phaseStats(Phase phase) const
+{
+    if (phase < 0 || phase >= PHASE_COUNT)
+    {
+        Stats empty = {0, 0, 0};
+        return empty;
+    }
+    return computeStats(phaseSamples[phase]);
+}
+
+FrameProfiler::Stats FrameProfiler::frameStats() const
+{
+    return computeStats(frameSamples);
+}
+
+FrameProfiler::Stats FrameProfiler::allocationStats() const
+{
+    return computeStats(allocationSamples);
+}
+
+QString FrameProfiler::overlayText() const
+{
+    QStringList lines;
+    lines << QString("%1 %2 %3 %4  (ms, %5 帧)")
+                 .arg(QStringLiteral("phase"), -14)
+                 .arg(QStringLiteral("min"), 7)
+                 .arg(QStringLiteral("avg"), 7)
+                 .arg(QStringLiteral("p99"), 7)
+                 .arg(sampleCount);
+
+    for (int i = 0; i < PHASE_COUNT; ++i)
+    {
+        Phase phase = static_cast<Phase>(i);
+        Stats stats = phaseStats(phase);
+        lines << QString("%1 %2 %3 %4")
+                     .arg(QString::fromLatin1(phaseName(phase)), -14)
+                     .arg(formatMs(stats.minNs))
+                     .arg(formatMs(stats.avgNs))
+                     .arg(formatMs(stats.p99Ns));
+    }
+
+    Stats frame = frameStats();
+    lines << QString("%1 %2 %3 %4")
+                 .arg(QStringLiteral("total"), -14)
+                 .arg(formatMs(frame.minNs))
+                 .arg(formatMs(frame.avgNs))
+                 .arg(formatMs(frame.p99Ns));
+
+    if (countsAllocations())
+    {
+        Stats allocations = allocationStats();
+        lines << QString("allocs/tick    %1 %2 %3")
+                     .arg(allocations.minNs, 7)
+                     .arg(allocations.avgNs, 7)
+                     .arg(allocations.p99Ns, 7);
+    }
+    else
+    {
+        lines << QString("allocs/tick    %1").arg(QStringLiteral("n/a"), 7);
+    }
+    lines << QString("敌人 %1  防御塔 %2  子弹 %3")
+                 .arg(enemyCount)
+                 .arg(towerCount)
+                 .arg(bulletCount);
+    if (levelStartMs >= 0)
+        lines << QString("选关到首帧 %1 ms").arg(levelStartMs);
+
+    return lines.join('\n');
+}
+
+namespace
+{
+    const char *phaseCategory(FrameProfiler::Phase phase)
+    {
+        return phase == FrameProfiler::PHASE_PAINT ? "render" : "sim";
+    }
+}
+
+ScopedPhaseTimer::ScopedPhaseTimer(FrameProfiler::Phase phase)
+    : phase(phase)
+{
+    TraceRecorder::instance().begin(FrameProfiler::phaseName(phase), phaseCategory(phase));
+    timer.start();
+}
+
+ScopedPhaseTimer::~ScopedPhaseTimer()
+{
+    FrameProfiler::instance().addPhaseTime(phase, timer.nsecsElapsed());
+    TraceRecorder::instance().end(FrameProfiler::phaseName(phase), phaseCategory(phase));
+}
@@ -1,11 +1,57 @@
 #include "include/gamemanager.h"
 #include "include/resourcemanager.h"
-#include "include/quadtree.h"
+#include "include/frameprofiler.h"
+#include "include/tracerecorder.h"
+#include "include/simdkernels.h"
+#include "include/fastmath.h"
+#include "include/logger.h"
 
 #include <cmath>
 #include <QRandomGenerator>
+#include <QDataStream>
+#include <QGraphicsScene>
+#include <QHash>
 #include <QDebug>
 
+namespace
+{
+    // 存档格式：'TEVS' 魔数 + 版本号，字段变更时递增版本
+    const quint32 SAVE_MAGIC = 0x54455653;
+    const quint16 SAVE_VERSION = 4;
+
+    // 固定流版本、字节序与单精度浮点，保证存档紧凑且跨 Qt 版本可读
+    void prepareSaveStream(QDataStream &stream)
+    {
+        stream.setVersion(QDataStream::Qt_5_12);
+        stream.setByteOrder(QDataStream::LittleEndian);
+        stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    }
+
+    // 读取并校验存档头
+    bool readSaveHeader(QDataStream &in, GameConfig::MapId *mapId, int *wave)
+    {
+        quint32 magic = 0;
+        quint16 version = 0;
+        qint8 savedMap = 0;
+        qint16 savedWave = 0;
+        in >> magic >> version >> savedMap >> savedWave;
+        if (in.status() != QDataStream::Ok || magic != SAVE_MAGIC || version != SAVE_VERSION)
+            return false;
+        if (savedMap < 0 || savedMap >= GameConfig::MAP_COUNT)
+            return false;
+        *mapId = static_cast<GameConfig::MapId>(savedMap);
+        *wave = savedWave;
+        return true;
+    }
+
+    // 敌人左上角坐标所在的格子，与 Enemy 流场寻路的取法一致
+    QPoint enemyCell(const QPointF &topLeft)
+    {
+        QPointF center = topLeft + QPointF(GameConfig::ENEMY_SIZE / 2, GameConfig::ENEMY_SIZE / 2);
+        return QPoint(OccupancyGrid::cellX(center), OccupancyGrid::cellY(center));
+    }
+}
+
 GameManager::GameManager(QObject *parent)
     : QObject(parent),
       gold(GameConfig::INITIAL_GOLD),
@@ -15,23 +61,101 @@ GameManager::GameManager(QObject *parent)
       waveSpawnComplete(false),
       gameRunning(false),
       paused(false),
+      firstTickPending(false),
       killCount(0),
+      snapshotValid(false),
       currentMapId(GameConfig::MAP1),
+      openField(false),
+      spawnAccumulatorMs(0),
+      waveEnemyCountOverride(0),
+      spawnIntervalOverrideMs(0),
+      enemyTypeRandom(QRandomGenerator::global()->generate64()),
       gameTimer(new QTimer(this)),
-      enemySpawnTimer(new QTimer(this)),
       resourceManager(&ResourceManager::instance())
 {
     connect(gameTimer, &QTimer::timeout, this, &GameManager::updateGame);
-    connect(enemySpawnTimer, &QTimer::timeout, this, &GameManager::spawnEnemy);
+    // 日志只记数值：0 标量、1 SSE2、2 AVX2
+    LOG_INFO(CATEGORY_GAME, "Batch kernel backend %1", static_cast<int>(SimdKernels::activeBackend()));
 }
 
 void GameManager::initialize(GameConfig::MapId mapId,
-                             const QVector<QPointF> &path,
+                             const QVector<QSharedPointer<const LanePath>> &lanes,
                              const QVector<GameConfig::EndPointConfig> &endPoints)
 {
     currentMapId = mapId;
-    pathPoints = path;
+    lanePaths = lanes;
     endPointAreas = endPoints;
+    occupancy = OccupancyGrid::buildForMap(mapId);
+    openField = GameConfig::MapPaths::OPEN_FIELD_MAPS.contains(mapId);
+    rebuildFlowField();
+
+    // 地图刚装好时即为关卡初始状态，重开直接回到这里（含随机序列，敌人顺序可复现）
+    captureSnapshot();
+}
+
+QVector<QSharedPointer<const LanePath>> GameManager::buildLanePaths(GameConfig::MapId mapId)
+{
+    QVector<QVector<GameConfig::GridPoint>> lanes = GameConfig::MapPaths::LANE_MAP.value(mapId);
+    if (lanes.isEmpty())
+        lanes << GameConfig::MapPaths::MAP1_PATH;
+
+    // 敌人贴图左上角对齐到格子中心
+    QVector<QSharedPointer<const LanePath>> paths;
+    const qreal offset = GameConfig::GRID_SIZE / 2 - GameConfig::ENEMY_SIZE / 2;
+    for (const QVector<GameConfig::GridPoint> &lane : lanes)
+    {
+        QVector<QPointF> points;
+        for (const GameConfig::GridPoint &gridPoint : lane)
+        {
+            qreal x = gridPoint.gridX * GameConfig::GRID_SIZE + offset;
+            qreal y = gridPoint.gridY * GameConfig::GRID_SIZE + offset;
+            points << QPointF(x, y);
+        }
+        paths << QSharedPointer<const LanePath>(new LanePath(points));
+    }
+    return paths;
+}
+
+QVector<GameConfig::EndPointConfig> GameManager::buildEndPoints(GameConfig::MapId mapId)
+{
+    QVector<QVector<GameConfig::GridPoint>> lanes = GameConfig::MapPaths::LANE_MAP.value(mapId);
+    if (lanes.isEmpty())
+        lanes << GameConfig::MapPaths::MAP1_PATH;
+
+    QVector<GameConfig::EndPointConfig> endPoints;
+    for (const QVector<GameConfig::GridPoint> &lane : lanes)
+    {
+        if (lane.isEmpty())
+            continue;
+
+        const GameConfig::GridPoint &lastPoint = lane.last();
+        qreal centerX = lastPoint.gridX * GameConfig::GRID_SIZE + GameConfig::GRID_SIZE / 2;
+        qreal centerY = lastPoint.gridY * GameConfig::GRID_SIZE + GameConfig::GRID_SIZE / 2;
+        bool shared = false;
+        for (const GameConfig::EndPointConfig &end : endPoints)
+            shared = shared || (end.x == centerX && end.y == centerY);
+        if (!shared)
+            endPoints.append({centerX, centerY, GameConfig::GRID_SIZE / 2});
+    }
+    return endPoints;
+}
+
+void GameManager::setGold(int newGold)
+{
+    gold = newGold;
+    emit goldChanged(gold);
+}
+
+void GameManager::setLives(int newLives)
+{
+    lives = newLives;
+    emit livesChanged(lives);
+}
+
+void GameManager::setWaveOverride(int enemyCount, int spawnIntervalMs)
+{
+    waveEnemyCountOverride = enemyCount > 0 ? enemyCount : 0;
+    spawnIntervalOverrideMs = spawnIntervalMs > 0 ? spawnIntervalMs : 0;
 }
 
 void GameManager::startGame()
@@ -39,12 +163,12 @@ void GameManager::startGame()
     if (gameRunning)
         return;
 
-    killCount = 0;
+    // 击杀数与刷怪节拍由 resetGame / restoreSnapshot / loadState 负责，读档后继续计时
     gameRunning = true;
     paused = false;
+    firstTickPending = true;
 
     gameTimer->start(GameConfig::GAME_TICK_INTERVAL_MS);
-    enemySpawnTimer->start(getWaveSpawnInterval());
 
     emit gameStateChanged(gameRunning, paused);
 }
@@ -59,12 +183,10 @@ void GameManager::pauseGame()
     if (paused)
     {
         gameTimer->stop();
-        enemySpawnTimer->stop();
     }
     else
     {
         gameTimer->start(GameConfig::GAME_TICK_INTERVAL_MS);
-        enemySpawnTimer->start(getWaveSpawnInterval());
     }
 
     emit gameStateChanged(gameRunning, paused);
@@ -74,12 +196,12 @@ void GameManager::resetGame()
 {
     if (gameTimer->isActive())
         gameTimer->stop();
-    if (enemySpawnTimer->isActive())
-        enemySpawnTimer->stop();
 
     enemies.clear();
     towers.clear();
     bullets.clear();
+    occupancy.clearTowers();
+    rebuildFlowField();
 
     gold = GameConfig::INITIAL_GOLD;
     lives = GameConfig::INITIAL_LIVES;
@@ -89,12 +211,268 @@ void GameManager::resetGame()
     gameRunning = false;
     paused = false;
     killCount = 0;
+    spawnAccumulatorMs = 0;
+
+    emit goldChanged(gold);
+    emit livesChanged(lives);
+    emit waveChanged(currentWave);
+    emit killCountChanged(killCount);
+    emit gameStateChanged(gameRunning, paused);
+}
+
+void GameManager::captureSnapshot()
+{
+    snapshot.gold = gold;
+    snapshot.lives = lives;
+    snapshot.currentWave = currentWave;
+    snapshot.enemiesSpawnedThisWave = enemiesSpawnedThisWave;
+    snapshot.waveSpawnComplete = waveSpawnComplete;
+    snapshot.killCount = killCount;
+    snapshot.spawnAccumulatorMs = spawnAccumulatorMs;
+    snapshot.enemyTypeRandom = enemyTypeRandom;
+    snapshotValid = true;
+}
+
+void GameManager::restoreSnapshot()
+{
+    if (!snapshotValid)
+    {
+        resetGame();
+        return;
+    }
+
+    if (gameTimer->isActive())
+        gameTimer->stop();
+
+    // 实体对象由页面从场景中移除，这里只放掉引用
+    enemies.clear();
+    towers.clear();
+    bullets.clear();
+    occupancy.clearTowers();
+    rebuildFlowField();
+
+    const int oldGold = gold;
+    const int oldLives = lives;
+    const int oldWave = currentWave;
+    const int oldKillCount = killCount;
+    const bool oldRunning = gameRunning;
+    const bool oldPaused = paused;
+
+    gold = snapshot.gold;
+    lives = snapshot.lives;
+    currentWave = snapshot.currentWave;
+    enemiesSpawnedThisWave = snapshot.enemiesSpawnedThisWave;
+    waveSpawnComplete = snapshot.waveSpawnComplete;
+    killCount = snapshot.killCount;
+    spawnAccumulatorMs = snapshot.spawnAccumulatorMs;
+    enemyTypeRandom = snapshot.enemyTypeRandom;
+    gameRunning = false;
+    paused = false;
+    firstTickPending = false;
+
+    if (gold != oldGold)
+        emit goldChanged(gold);
+    if (lives != oldLives)
+        emit livesChanged(lives);
+    if (currentWave != oldWave)
+        emit waveChanged(currentWave);
+    if (killCount != oldKillCount)
+        emit killCountChanged(killCount);
+    if (gameRunning != oldRunning || paused != oldPaused)
+        emit gameStateChanged(gameRunning, paused);
+}
+
+QByteArray GameManager::saveState() const
+{
+    QByteArray data;
+    data.reserve(64 + enemies.size() * 32 + towers.size() * 96 + bullets.size() * 48);
+    QDataStream out(&data, QIODevice::WriteOnly);
+    prepareSaveStream(out);
+
+    out << SAVE_MAGIC << SAVE_VERSION
+        << static_cast<qint8>(currentMapId)
+        << static_cast<qint16>(currentWave)
+        << static_cast<qint32>(gold)
+        << static_cast<qint32>(lives)
+        << static_cast<qint16>(enemiesSpawnedThisWave)
+        << waveSpawnComplete
+        << static_cast<qint32>(killCount)
+        << static_cast<qint32>(spawnAccumulatorMs)
+        << enemyTypeRandom.state();
+
+    // 塔与子弹按下标引用敌人，先确定存活敌人的顺序
+    QHash<const Enemy *, int> enemyIndex;
+    QList<const Enemy *> liveEnemies;
+    for (const QPointer<Enemy> &enemy : enemies)
+    {
+        if (!enemy)
+            continue;
+        enemyIndex.insert(enemy.data(), liveEnemies.size());
+        liveEnemies.append(enemy.data());
+    }
+
+    out << static_cast<quint16>(liveEnemies.size());
+    for (const Enemy *enemy : liveEnemies)
+        enemy->saveState(out);
+
+    int towerCount = 0;
+    for (const QPointer<Tower> &tower : towers)
+    {
+        if (tower)
+            towerCount++;
+    }
+    out << static_cast<quint16>(towerCount);
+    for (const QPointer<Tower> &tower : towers)
+    {
+        if (tower)
+            tower->saveState(out, enemyIndex);
+    }
+
+    int bulletCount = 0;
+    for (const QPointer<Bullet> &bullet : bullets)
+    {
+        if (bullet && !bullet->isFinished())
+            bulletCount++;
+    }
+    out << static_cast<quint16>(bulletCount);
+    for (const QPointer<Bullet> &bullet : bullets)
+    {
+        if (bullet && !bullet->isFinished())
+            bullet->saveState(out, enemyIndex);
+    }
+
+    return data;
+}
+
+bool GameManager::peekSave(const QByteArray &data, GameConfig::MapId *mapId, int *wave)
+{
+    QDataStream in(data);
+    prepareSaveStream(in);
+    return readSaveHeader(in, mapId, wave);
+}
+
+bool GameManager::loadState(const QByteArray &data, QGraphicsScene *scene, QObject *parentForTowers)
+{
+    QDataStream in(data);
+    prepareSaveStream(in);
+
+    GameConfig::MapId savedMap = GameConfig::MAP1;
+    int savedWave = 1;
+    if (!readSaveHeader(in, &savedMap, &savedWave) || savedMap != currentMapId)
+        return false;
+
+    qint32 savedGold = 0;
+    qint32 savedLives = 0;
+    qint16 savedSpawned = 0;
+    bool savedSpawnComplete = false;
+    qint32 savedKills = 0;
+    qint32 savedAccumulator = 0;
+    quint64 savedRandomState = 0;
+    in >> savedGold >> savedLives >> savedSpawned >> savedSpawnComplete
+       >> savedKills >> savedAccumulator >> savedRandomState;
+
+    // 先把实体全部读出来，任何一处损坏都整体放弃，不留下半个对局
+    QList<QPointer<Enemy>> loadedEnemies;
+    QList<QPointer<Tower>> loadedTowers;
+    QList<QPointer<Bullet>> loadedBullets;
+    bool ok = in.status() == QDataStream::Ok;
+
+    quint16 count = 0;
+    in >> count;
+    for (quint16 i = 0; ok && i < count; ++i)
+    {
+        Enemy *enemy = Enemy::restoreState(in, lanePaths, this);
+        ok = enemy != nullptr;
+        if (ok)
+            loadedEnemies.append(enemy);
+    }
+
+    count = 0;
+    in >> count;
+    for (quint16 i = 0; ok && i < count; ++i)
+    {
+        Tower *tower = Tower::restoreState(in, loadedEnemies, parentForTowers);
+        ok = tower != nullptr;
+        if (ok)
+            loadedTowers.append(tower);
+    }
+
+    count = 0;
+    in >> count;
+    for (quint16 i = 0; ok && i < count; ++i)
+    {
+        Bullet *bullet = Bullet::restoreState(in, loadedEnemies, nullptr);
+        ok = bullet != nullptr;
+        if (ok)
+            loadedBullets.append(bullet);
+    }
+
+    if (!ok || in.status() != QDataStream::Ok)
+    {
+        qWarning() << "[GameManager] Save data is corrupt, ignoring";
+        for (const QPointer<Bullet> &bullet : loadedBullets)
+            delete bullet.data();
+        for (const QPointer<Tower> &tower : loadedTowers)
+            delete tower.data();
+        for (const QPointer<Enemy> &enemy : loadedEnemies)
+            delete enemy.data();
+        return false;
+    }
+
+    if (gameTimer->isActive())
+        gameTimer->stop();
+
+    gold = savedGold;
+    lives = savedLives;
+    currentWave = savedWave;
+    enemiesSpawnedThisWave = savedSpawned;
+    waveSpawnComplete = savedSpawnComplete;
+    killCount = savedKills;
+    spawnAccumulatorMs = savedAccumulator;
+    enemyTypeRandom.setState(savedRandomState);
+    gameRunning = false;
+    paused = false;
+    firstTickPending = false;
+
+    // 与正常生成走同一条路径加入场景
+    enemies = loadedEnemies;
+    for (const QPointer<Enemy> &enemy : enemies)
+    {
+        if (openField)
+            enemy->setFlowField(&flowField);
+        emit enemySpawnRequested(enemy);
+    }
+
+    towers.clear();
+    occupancy.clearTowers();
+    for (const QPointer<Tower> &tower : loadedTowers)
+    {
+        occupancy.setTower(OccupancyGrid::cellX(tower->pos()), OccupancyGrid::cellY(tower->pos()), tower);
+        if (resourceManager)
+            tower->setResourceManager(resourceManager);
+        tower->setGameScene(scene);
+        trackTowerBullets(tower);
+        towers.append(tower);
+        emit towerBuilt(tower);
+    }
+    rebuildFlowField();
+
+    bullets.clear();
+    for (const QPointer<Bullet> &bullet : loadedBullets)
+    {
+        if (resourceManager)
+            bullet->setResourceManager(resourceManager);
+        if (scene)
+            scene->addItem(bullet);
+        bullets.append(bullet);
+    }
 
     emit goldChanged(gold);
     emit livesChanged(lives);
     emit waveChanged(currentWave);
     emit killCountChanged(killCount);
     emit gameStateChanged(gameRunning, paused);
+    return true;
 }
 
 void GameManager::spawnEnemy()
@@ -102,7 +480,9 @@ void GameManager::spawnEnemy()
     if (!gameRunning || paused)
         return;
 
-    if (enemiesSpawnedThisWave >= GameConfig::WAVE_ENEMY_COUNT)
+    TraceScope traceScope("spawnEnemy", "sim");
+
+    if (enemiesSpawnedThisWave >= getWaveEnemyCount())
     {
         if (!waveSpawnComplete)
         {
@@ -120,7 +500,7 @@ void GameManager::spawnEnemy()
     // 后面几波敌人随机
     else
     {
-        int index = QRandomGenerator::global()->bounded(GameConfig::ENEMY_TYPE_NUMBER);
+        int index = enemyTypeRandom.bounded(GameConfig::ENEMY_TYPE_NUMBER);
         enemyType = index;
     }
     QPointer<Enemy> enemy = new Enemy(enemyType, this);
@@ -129,7 +509,15 @@ void GameManager::spawnEnemy()
     enemy->setHealth(waveHealth);
     float waveSpeed = calculateWaveSpeed();
     enemy->setSpeed(waveSpeed);
-    enemy->setPath(pathPoints);
+    // 各条路线轮流出兵，不占用随机序列，存档与重开都可复现
+    if (!lanePaths.isEmpty())
+    {
+        int lane = enemiesSpawnedThisWave % lanePaths.size();
+        enemy->setLane(lane);
+        enemy->setPath(lanePaths[lane]);
+    }
+    if (openField)
+        enemy->setFlowField(&flowField);
 
     enemies.append(enemy);
     enemiesSpawnedThisWave++;
@@ -138,19 +526,45 @@ void GameManager::spawnEnemy()
 }
 
 void GameManager::updateGame()
+{
+    stepSimulation(GameConfig::GAME_TICK_INTERVAL_MS);
+}
+
+void GameManager::stepSimulation(int dtMs)
 {
     if (!gameRunning || paused)
         return;
 
-    updateEnemies();
-    updateTowers();
+    TraceScope traceScope("tick", "sim");
+
+    // 本帧内塔、子弹与管理器的音效请求合并后统一播放
+    if (resourceManager)
+        resourceManager->beginSoundBatch();
+
+    // 所有实体节拍都由这里统一推进，不再各自持有计时器
+    updateSpawner(dtMs);
+    updateEnemies(dtMs);
+    updateTowers(dtMs);
+    updateBullets(dtMs);
     removeDeadEntities();
     checkNextWave();
 
+    if (resourceManager)
+        resourceManager->flushSoundBatch();
+
+    FrameProfiler &profiler = FrameProfiler::instance();
+    profiler.setEntityCounts(enemies.size(), towers.size(), Bullet::getLiveCount());
+    profiler.endFrame();
+
+    if (firstTickPending)
+    {
+        firstTickPending = false;
+        emit firstTickSimulated();
+    }
+
     if (lives <= 0)
     {
         gameTimer->stop();
-        enemySpawnTimer->stop();
         gameRunning = false;
         paused = true;
         emit gameStateChanged(gameRunning, paused);
@@ -159,18 +573,65 @@ void GameManager::updateGame()
     }
 }
 
-void GameManager::updateEnemies()
+void GameManager::updateSpawner(int dtMs)
+{
+    // 按当前波次间隔累加，同一帧内可能生成多只
+    spawnAccumulatorMs += dtMs;
+    int interval = getWaveSpawnInterval();
+    while (spawnAccumulatorMs >= interval && gameRunning && !waveSpawnComplete)
+    {
+        spawnAccumulatorMs -= interval;
+        spawnEnemy();
+    }
+}
+
+void GameManager::updateEnemies(int dtMs)
 {
+    ScopedPhaseTimer phaseTimer(FrameProfiler::PHASE_UPDATE_ENEMIES);
+
     QList<QPointer<Enemy>> enemiesToRemove;
 
+    // 沿固定路线的敌人只需推进弧长，收进连续数组整批计算；走流场的仍逐个移动
+    EnemyBatch &batch = enemyBatch;
+    batch.items.resize(enemies.size());
+    batch.progress.resize(enemies.size());
+    batch.speed.resize(enemies.size());
+    batch.steps.resize(enemies.size());
+    batch.length.resize(enemies.size());
+    int batched = 0;
     for (QPointer<Enemy> enemy : enemies)
     {
         if (!enemy)
             continue;
 
-        enemy->update();
+        if (enemy->isOnLanePath() && !enemy->isAtEnd())
+        {
+            batch.items[batched] = enemy;
+            batch.progress[batched] = enemy->getProgress();
+            batch.speed[batched] = enemy->getSpeed();
+            // 与 advance 之后再 update 一次的逐个推进步数一致
+            batch.steps[batched] = static_cast<float>(enemy->takeMoveSteps(dtMs) + 1);
+            batch.length[batched] = enemy->getPathLength();
+            batched++;
+        }
+        else
+        {
+            enemy->advance(dtMs);
+            enemy->update();
+        }
+    }
+
+    SimdKernels::advanceProgress(batch.progress.data(), batch.speed.constData(), batch.steps.constData(),
+                                 batch.length.constData(), batched);
+    for (int i = 0; i < batched; ++i)
+        batch.items[i]->setProgress(batch.progress[i]);
+
+    for (QPointer<Enemy> enemy : enemies)
+    {
+        if (!enemy)
+            continue;
 
-        if (isEnemyAtAnyEndPoint(enemy))
+        if (hasReachedEnd(enemy))
         {
             lives--;
             emit livesChanged(lives);
@@ -185,20 +646,24 @@ void GameManager::updateEnemies()
     }
 }
 
-void GameManager::updateTowers()
+void GameManager::updateTowers(int dtMs)
 {
-    // 使用四叉树优化塔台更新
-    QRectF mapBounds(0, 0, GameConfig::WINDOW_WIDTH, GameConfig::WINDOW_HEIGHT);
-    Quadtree quadtree(mapBounds, 4); // 将四叉树划分为四个区域，每个区域最多可容纳 4 个敌人
-
-    // 将所有活着的敌人插入四叉树
-    for (QPointer<Enemy> enemy : enemies)
+    ScopedPhaseTimer phaseTimer(FrameProfiler::PHASE_UPDATE_TOWERS);
+
+    // 收集本帧敌人坐标，索引按敌人与塔的数量自行挑选查询实现
+    TargetingScratch &scratch = targetingScratch;
+    scratch.items.resize(0);
+    scratch.x.resize(0);
+    scratch.y.resize(0);
+    for (const QPointer<Enemy> &enemy : enemies)
     {
-        if (enemy)
-        {
-            quadtree.insert(enemy);
-        }
+        if (!enemy)
+            continue;
+        scratch.items.append(enemy.data());
+        scratch.x.append(static_cast<float>(enemy->x()));
+        scratch.y.append(static_cast<float>(enemy->y()));
     }
+    targeting.rebuild(scratch.x, scratch.y, towers.size());
 
     // 遍历所有塔并更新它们
     for (QPointer<Tower> tower : towers)
@@ -206,41 +671,194 @@ void GameManager::updateTowers()
         if (!tower)
             continue;
 
-        // 计算该塔的射程
-        qreal range = tower->getRange();
-        QRectF queryRect(tower->x() - range, tower->y() - range, range * 2, range * 2);
+        tower->advance(dtMs);
 
-        // 查询四叉树以查找防御塔范围内的所有敌人
-        QList<Enemy *> potentialEnemies;
-        quadtree.query(queryRect, potentialEnemies);
-
-        // 创建一份位于防御塔射程内的敌人列表
+        // 查询结果按敌人列表顺序给出，同时入射程的敌人按生成先后锁定
+        targeting.queryCircle(static_cast<float>(tower->x()), static_cast<float>(tower->y()),
+                              static_cast<float>(tower->getRange()), &scratch.hits);
         QList<QPointer<Enemy>> enemiesInRange;
-        for (Enemy *rawEnemy : potentialEnemies)
+        enemiesInRange.reserve(scratch.hits.size());
+        for (int index : scratch.hits)
+            enemiesInRange.append(QPointer<Enemy>(scratch.items[index]));
+
+        // 将敌人置于防御塔的攻击范围内，并更新防御塔
+        tower->setEnemiesInRange(enemiesInRange);
+        tower->update();
+    }
+}
+
+void GameManager::updateBullets(int dtMs)
+{
+    ScopedPhaseTimer phaseTimer(FrameProfiler::PHASE_BULLETS);
+
+    // 敌人本帧已走完，按中心建一次宽相位索引；子弹每步的位移线段只与附近敌人精确求交
+    bulletColliders.clear();
+    if (!bullets.isEmpty())
+    {
+        for (const QPointer<Enemy> &enemy : enemies)
+        {
+            if (enemy)
+                bulletColliders.insert(enemy.data(), enemy->getCenterPosition());
+        }
+        bulletColliders.build();
+    }
+
+    // 推进过程中可能有塔开火追加子弹，新追加的一段接着走同样的流程
+    int first = 0;
+    while (first < bullets.size())
+    {
+        const int last = bullets.size();
+        stepBullets(first, last, dtMs);
+        first = last;
+    }
+}
+
+void GameManager::stepBullets(int first, int last, int dtMs)
+{
+    // 先领取每颗子弹本帧的步数；多数帧每颗至多一步，按轮次整批推进
+    BulletBatch &batch = bulletBatch;
+    const int count = last - first;
+    batch.items.resize(count);
+    batch.steps.resize(count);
+    batch.x.resize(count);
+    batch.y.resize(count);
+    batch.dirX.resize(count);
+    batch.dirY.resize(count);
+    batch.targetX.resize(count);
+    batch.targetY.resize(count);
+    batch.speed.resize(count);
+    batch.tracking.resize(count);
+    batch.hit.resize(count);
+
+    int rounds = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        Bullet *bullet = bullets[first + i];
+        batch.steps[i] = 0;
+        if (!bullet)
+            continue;
+
+        // 解析弹道的命中时刻已定，不参与逐步追踪与扫掠检测
+        if (bullet->isAnalytic())
+        {
+            bullet->advanceFlight(dtMs);
+            continue;
+        }
+        batch.steps[i] = bullet->takeMoveSteps(dtMs);
+        rounds = qMax(rounds, batch.steps[i]);
+    }
+
+    const float hitRadius = GameConfig::ENEMY_COLLISION_RADIUS + GameConfig::BULLET_COLLISION_RADIUS;
+    float sinMaxTurn = 0.0f;
+    float cosMaxTurn = 1.0f;
+    FastMath::sincos(GameConfig::BULLET_MAX_TURN_DEG * FastMath::DEG_TO_RAD, &sinMaxTurn, &cosMaxTurn);
+    for (int round = 0; round < rounds; ++round)
+    {
+        int batched = 0;
+        for (int i = 0; i < count; ++i)
         {
-            QPointer<Enemy> enemy(rawEnemy);
-            if (!enemy)
+            Bullet *bullet = bullets[first + i];
+            if (!bullet || bullet->isFinished() || batch.steps[i] <= round)
                 continue;
 
-            // 使用距离的平方来检查敌人是否在防御塔的射程内
-            qreal dx = enemy->x() - tower->x();
-            qreal dy = enemy->y() - tower->y();
-            qreal distSq = dx * dx + dy * dy;
+            // 目标已被打死但尚未移出场景时按丢失目标处理，不再追着尸体飞
+            Enemy *target = bullet->getTarget();
+            if (target && target->getHealth() <= 0)
+                target = nullptr;
+            if (!target && bullet->expireLostTarget())
+                continue;
 
-            if (distSq <= range * range)
+            QPointF position = bullet->pos();
+            QPointF direction = bullet->getDirection();
+            QPointF targetCenter = target ? target->getCenterPosition() : position;
+            batch.items[batched] = bullet;
+            batch.x[batched] = static_cast<float>(position.x());
+            batch.y[batched] = static_cast<float>(position.y());
+            batch.dirX[batched] = static_cast<float>(direction.x());
+            batch.dirY[batched] = static_cast<float>(direction.y());
+            batch.targetX[batched] = static_cast<float>(targetCenter.x());
+            batch.targetY[batched] = static_cast<float>(targetCenter.y());
+            batch.speed[batched] = bullet->getSpeed();
+            batch.tracking[batched] = target ? 1 : 0;
+            batched++;
+        }
+
+        SimdKernels::HomingBatch homing = {
+            batch.x.data(), batch.y.data(), batch.dirX.data(), batch.dirY.data(),
+            batch.targetX.constData(), batch.targetY.constData(), batch.speed.constData(),
+            batch.tracking.data(), batch.hit.data(), batched
+        };
+        SimdKernels::stepHoming(homing, hitRadius, cosMaxTurn, sinMaxTurn);
+
+        // 内核只判定起点是否已碰到目标；其余子弹按本步整段位移扫掠，途经的任何敌人都会被打中
+        for (int i = 0; i < batched; ++i)
+        {
+            Bullet *bullet = batch.items[i];
+            if (batch.hit[i])
             {
-                enemiesInRange.append(enemy);
+                Enemy *target = bullet->getTarget();
+                if (target && target->getHealth() > 0)
+                {
+                    bullet->hitTarget();
+                    continue;
+                }
+                // 目标在本轮里先被别的子弹打死：放开目标，沿原方向走完这一步并照常扫掠
+                batch.x[i] += batch.dirX[i] * batch.speed[i];
+                batch.y[i] += batch.dirY[i] * batch.speed[i];
+                batch.tracking[i] = 0;
             }
+
+            QPointF nextPos(batch.x[i], batch.y[i]);
+            Enemy *struck = findSweptHit(bullet->pos(), nextPos, hitRadius);
+            if (struck)
+                bullet->hitEnemy(struck);
+            else
+                bullet->applyStep(nextPos, QPointF(batch.dirX[i], batch.dirY[i]), batch.tracking[i] != 0);
         }
+    }
+}
 
-        // 将敌人置于防御塔的攻击范围内，并更新防御塔
-        tower->setEnemiesInRange(enemiesInRange);
-        tower->update();
+Enemy *GameManager::findSweptHit(const QPointF &from, const QPointF &to, qreal radius)
+{
+    // 宽相位按 float 坐标筛选，放宽一像素，精确判定交给 sweepCircle
+    bulletColliders.querySegment(from, to, radius + 1.0, &sweepCandidates);
+
+    // 候选按敌人列表顺序给出，同一时刻接触时先生成的敌人优先
+    Enemy *earliest = nullptr;
+    qreal earliestTime = 2.0;
+    for (Enemy *enemy : sweepCandidates)
+    {
+        // 索引在本帧开头建好，之前的子弹已打死的敌人仍留在其中
+        if (enemy->getHealth() <= 0)
+            continue;
+        qreal time = 0.0;
+        if (Bullet::sweepCircle(from, to, enemy->getCenterPosition(), radius, &time) && time < earliestTime)
+        {
+            earliest = enemy;
+            earliestTime = time;
+        }
     }
+    return earliest;
+}
+
+void GameManager::trackTowerBullets(QPointer<Tower> tower)
+{
+    if (!tower)
+        return;
+
+    connect(tower, &Tower::bulletFired, this, [this](QPointer<Bullet> bullet) {
+        if (!bullet)
+            return;
+        // 目标沿固定路线时命中帧可在开火时算出，之后只插值显示
+        bullet->planIntercept(GameConfig::GAME_TICK_INTERVAL_MS);
+        bullets.append(bullet);
+    });
 }
 
 void GameManager::removeDeadEntities()
 {
+    ScopedPhaseTimer phaseTimer(FrameProfiler::PHASE_REMOVE_DEAD);
+
     QList<QPointer<Enemy>> deadEnemies;
 
     for (QPointer<Enemy> enemy : enemies)
@@ -266,18 +884,28 @@ void GameManager::removeDeadEntities()
     {
         enemies.removeOne(enemy);
     }
+
+    // 丢弃已命中或已销毁的子弹
+    QList<QPointer<Bullet>>::iterator it = bullets.begin();
+    while (it != bullets.end())
+    {
+        if (!*it || (*it)->isFinished())
+            it = bullets.erase(it);
+        else
+            ++it;
+    }
 }
 
 void GameManager::checkNextWave()
 {
+    ScopedPhaseTimer phaseTimer(FrameProfiler::PHASE_CHECK_WAVE);
+
     if (waveSpawnComplete && enemies.isEmpty())
     {
         if (currentWave >= GameConfig::WAVE_COUNT_MAX)
         {
             if (gameTimer->isActive())
                 gameTimer->stop();
-            if (enemySpawnTimer->isActive())
-                enemySpawnTimer->stop();
 
             gameRunning = false;
             paused = false;
@@ -291,15 +919,16 @@ void GameManager::checkNextWave()
         currentWave++;
         enemiesSpawnedThisWave = 0;
         waveSpawnComplete = false;
+        spawnAccumulatorMs = 0;
         emit waveChanged(currentWave);
-
-        int newInterval = getWaveSpawnInterval();
-        enemySpawnTimer->setInterval(newInterval);
     }
 }
 
 int GameManager::getWaveSpawnInterval() const
 {
+    if (spawnIntervalOverrideMs > 0)
+        return spawnIntervalOverrideMs;
+
     int interval = GameConfig::WAVE_SPAWN_INTERVAL_MAX -
                    GameConfig::WAVE_SPAWN_INTERVAL_EACH * (currentWave - 1);
     int minInterval = GameConfig::WAVE_SPAWN_INTERVAL_MIN;
@@ -312,6 +941,13 @@ int GameManager::getWaveSpawnInterval() const
     return interval;
 }
 
+int GameManager::getWaveEnemyCount() const
+{
+    if (waveEnemyCountOverride > 0)
+        return waveEnemyCountOverride;
+    return GameConfig::WAVE_ENEMY_COUNT;
+}
+
 int GameManager::calculateWaveHealth() const
 {
     const int base = GameConfig::ENEMY_HEALTH;
@@ -326,21 +962,69 @@ float GameManager::calculateWaveSpeed() const
     return GameConfig::ENEMY_SPEED * factor;
 }
 
-bool GameManager::isEnemyAtAnyEndPoint(QPointer<Enemy> enemy) const
+bool GameManager::hasReachedEnd(QPointer<Enemy> enemy) const
 {
-    if (!enemy || endPointAreas.isEmpty())
+    if (!enemy)
         return false;
 
-    QPointF enemyCenter = enemy->getCenterPosition();
+    // 开阔地图查终点格表；固定路线走完最后一个路径点即为抵达
+    if (openField)
+        return occupancy.isEndZone(enemyCell(enemy->pos()));
+    return enemy->isAtEnd();
+}
+
+void GameManager::rebuildFlowField()
+{
+    if (!openField)
+        return;
+
+    goalCells.clear();
     for (const GameConfig::EndPointConfig &end : endPointAreas)
+        goalCells << QPoint(static_cast<int>(end.x) / GameConfig::GRID_SIZE,
+                            static_cast<int>(end.y) / GameConfig::GRID_SIZE);
+    spawnCells.clear();
+    for (const QSharedPointer<const LanePath> &lane : lanePaths)
     {
-        qreal dx = enemyCenter.x() - end.x;
-        qreal dy = enemyCenter.y() - end.y;
-        qreal distance = std::sqrt(dx * dx + dy * dy);
-        if (distance <= end.radius)
-        {
+        if (!lane->isEmpty())
+            spawnCells << enemyCell(lane->start());
+    }
+
+    flowField.reset(occupancy, goalCells);
+    cutCells.rebuild(flowField, goalCells);
+}
+
+void GameManager::updateOpenFieldCell(int cellX, int cellY, bool blocked)
+{
+    if (!openField)
+        return;
+
+    if (blocked)
+        flowField.blockCell(cellX, cellY);
+    else
+        flowField.unblockCell(cellX, cellY);
+    // 一次 O(格子数) 的遍历只在建塔、拆塔时发生，悬停查询因此都是常数时间
+    cutCells.rebuild(flowField, goalCells);
+}
+
+bool GameManager::wouldBlockPath(int cellX, int cellY) const
+{
+    if (!openField)
+        return false;
+
+    const QPoint blockCell(cellX, cellY);
+    for (const QPoint &spawn : spawnCells)
+    {
+        if (cutCells.separates(blockCell, spawn))
+            return true;
+    }
+
+    // 场上的敌人也不能被关进死胡同；站在该格上的敌人会从相邻格脱身
+    for (const QPointer<Enemy> &enemy : enemies)
+    {
+        if (!enemy)
+            continue;
+        if (cutCells.separates(blockCell, enemyCell(enemy->pos())))
             return true;
-        }
     }
     return false;
 }
@@ -374,6 +1058,11 @@ void GameManager::playSound(const QString &soundId, qreal volume, bool loop)
 
 QPointer<Tower> GameManager::buildTower(Tower::TowerType type, const QPointF &position, QObject *parentForTower)
 {
+    const int cellX = OccupancyGrid::cellX(position);
+    const int cellY = OccupancyGrid::cellY(position);
+    if (!occupancy.canBuild(cellX, cellY) || wouldBlockPath(cellX, cellY))
+        return QPointer<Tower>();
+
     int cost = getTowerCost(type);
     if (gold < cost)
     {
@@ -388,7 +1077,10 @@ QPointer<Tower> GameManager::buildTower(Tower::TowerType type, const QPointF &po
     {
         tower->setResourceManager(resourceManager);
     }
+    trackTowerBullets(tower);
     towers.append(tower);
+    occupancy.setTower(cellX, cellY, tower);
+    updateOpenFieldCell(cellX, cellY, true);
     emit towerBuilt(tower);
 
     return tower;
@@ -437,7 +1129,9 @@ QPointer<Tower> GameManager::upgradeTower(QPointer<Tower> tower)
     {
         newTower->setResourceManager(resourceManager);
     }
+    trackTowerBullets(newTower);
     towers[index] = newTower;
+    occupancy.setTower(OccupancyGrid::cellX(position), OccupancyGrid::cellY(position), newTower);
 
     emit towerUpgraded(tower, newTower);
 
@@ -466,6 +1160,10 @@ bool GameManager::demolishTower(QPointer<Tower> tower)
     }
 
     towers.removeAt(index);
+    const int cellX = OccupancyGrid::cellX(tower->pos());
+    const int cellY = OccupancyGrid::cellY(tower->pos());
+    occupancy.clearTower(cellX, cellY);
+    updateOpenFieldCell(cellX, cellY, false);
 
     emit towerDemolished(tower);
 
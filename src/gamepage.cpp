@@ -3,7 +3,13 @@
 #include "include/config.h"
 #include "include/mainwindow.h"
 #include "include/gamemanager.h"
-#include "include/placementvalidator.h"
+#include "include/occupancygrid.h"
+#include "include/levelpreloader.h"
+#include "include/savegame.h"
+#include "include/progressstore.h"
+#include "include/frameprofiler.h"
+#include "include/tracerecorder.h"
+#include "include/logger.h"
 
 #include "ui_gamepage.h"
 
@@ -30,22 +36,44 @@
 #include <QAction>
 #include <QMessageBox>
 #include <QApplication>
-#include <QSettings>
+#include <QShortcut>
+#include <QKeySequence>
+#include <QStandardPaths>
+#include <QDir>
+#include <QDateTime>
 #include <cmath>
 
+namespace
+{
+    // 把列表中的实体移出场景并延迟删除
+    template <typename T>
+    void removeEntitiesFromScene(QGraphicsScene *scene, const QList<QPointer<T>> &entities)
+    {
+        for (const QPointer<T> &entity : entities)
+        {
+            if (!entity)
+                continue;
+            if (entity->scene() == scene)
+                scene->removeItem(entity);
+            entity->deleteLater();
+        }
+    }
+}
+
 GamePage::GamePage(QWidget *parent)
     : QWidget(parent),
       ui(new Ui::GamePage),
       gameScene(nullptr),
       gameView(nullptr),
-      placementValidator(nullptr),
       gameManager(new GameManager(this)),
       currentMapId(GameConfig::MAP1),
       userItem(nullptr),
       resultOverlay(nullptr),
       resultPanel(nullptr),
       pauseOverlay(nullptr),
-      pausePanel(nullptr)
+      pausePanel(nullptr),
+      profilerOverlay(nullptr),
+      profilerRefreshTimer(nullptr)
 {
     qDebug() << "GamePage constructor called";
 
@@ -55,7 +83,9 @@ GamePage::GamePage(QWidget *parent)
 
     initUI();
     initGameScene();
-    setMap(currentMapId);
+    initProfilerOverlay();
+    // 关卡内容推迟到 setMap：空闲预建页面时不在 GUI 线程同步解码地图
+    updateGameStats();
 
     connect(gameManager, &GameManager::goldChanged, this, [this](int gold) {
         if (goldLabel)
@@ -78,9 +108,19 @@ GamePage::GamePage(QWidget *parent)
             }
         }
     });
+    connect(gameManager, &GameManager::firstTickSimulated, this, [this]() {
+        qint64 elapsedMs = levelStartClock.isValid() ? levelStartClock.elapsed() : -1;
+        LOG_INFO(CATEGORY_GAME, "Map %1 selected to first tick: %2 ms", static_cast<int>(currentMapId), elapsedMs);
+        // 日志在发布版编译期剔除，同时记入分析器叠加层与追踪时间线
+        FrameProfiler::instance().setLevelStartMs(elapsedMs);
+        TraceRecorder::instance().instant("first_tick", "sim");
+    });
     connect(gameManager, &GameManager::waveChanged, this, [this](int wave) {
         if (waveLabel)
             waveLabel->setText(QString("第 %1 波").arg(wave));
+        // 只在对局进行中跨过波次边界时自动存档，重置与读档引起的波次变化不算
+        if (gameManager->isGameRunning())
+            autosave();
     });
     connect(gameManager, &GameManager::enemySpawnRequested, this, [this](QPointer<Enemy> enemy) {
         if (enemy && gameScene)
@@ -98,7 +138,9 @@ GamePage::GamePage(QWidget *parent)
     connect(gameManager, &GameManager::enemyDied, this, [this](QPointer<Enemy> enemy) {
         if (enemy && gameScene)
         {
+            dyingEnemies.append(enemy);
             QTimer::singleShot(GameConfig::ENEMY_DEAD_KEEP_TIME, [this, enemy]() {
+                dyingEnemies.removeAll(enemy);
                 if (enemy && gameScene)
                 {
                     gameScene->removeItem(enemy);
@@ -118,6 +160,7 @@ GamePage::GamePage(QWidget *parent)
         }
 
         gameScene->addItem(tower);
+        tower->setGameScene(gameScene);
     });
     connect(gameManager, &GameManager::towerUpgraded, this, [this](QPointer<Tower> oldTower, QPointer<Tower> newTower) {
         if (!gameScene)
@@ -184,9 +227,6 @@ GamePage::~GamePage()
         delete userItem;
         userItem = nullptr;
     }
-    qDeleteAll(placementAreaItems);
-    placementAreaItems.clear();
-    delete placementValidator;
     resetGame();
 }
 
@@ -205,6 +245,7 @@ void GamePage::updateGameStats()
 
 void GamePage::setMap(GameConfig::MapId mapId)
 {
+    levelStartClock.start();
     currentMapId = mapId;
 
     if (gameScene)
@@ -222,19 +263,15 @@ void GamePage::setMap(GameConfig::MapId mapId)
         gameScene->clear();
     }
 
-    pathPoints.clear();
-    endPointAreas.clear();
-    placementAreaItems.clear();
-
-    createPath();
-    drawBackground();
-    drawGrid();
-    initPlacementValidator();
+    // 路径与静态底图通常已在关卡选择页停留期间于后台备好
+    PreparedLevel level = LevelPreloader::instance().acquire(currentMapId);
+    endPointAreas = level.endPoints;
+    drawBackground(LevelPreloader::instance().staticPixmap(currentMapId));
 
     if (gameManager)
     {
         gameManager->resetGame();
-        gameManager->initialize(currentMapId, pathPoints, endPointAreas);
+        gameManager->initialize(currentMapId, level.lanePaths, endPointAreas);
         updateGameStats();
     }
 }
@@ -370,22 +407,17 @@ void GamePage::initGameScene()
     gameView->viewport()->setMouseTracking(true);
     gameView->viewport()->installEventFilter(this);
 
-    drawBackground();
-    drawGrid();
-    drawPlacementAreas();
-
     controlPanel->raise();
 
     qDebug() << "Game scene initialized, view size:" << gameView->size();
 }
 
-void GamePage::drawBackground()
+void GamePage::drawBackground(const QPixmap &staticLayer)
 {
     ResourceManager &rm = ResourceManager::instance();
-    QPixmap background = rm.getGameMap(currentMapId);
 
-    // 创建背景图形项 - 占据整个800x600
-    QGraphicsPixmapItem *backgroundItem = new QGraphicsPixmapItem(background);
+    // 地图、网格与建造格已合成一张图，整屏只需一个图形项
+    QGraphicsPixmapItem *backgroundItem = new QGraphicsPixmapItem(staticLayer);
     backgroundItem->setZValue(-100); // 最底层
     gameScene->addItem(backgroundItem);
 
@@ -429,66 +461,6 @@ void GamePage::drawBackground()
     // }
 }
 
-void GamePage::drawGrid()
-{
-    QPen gridPen(QColor(200, 255, 200, 100), 1);
-
-    // 绘制垂直线
-    for (int x = 0; x <= GameConfig::WINDOW_WIDTH; x += GameConfig::GRID_SIZE)
-    {
-        QGraphicsLineItem *line = new QGraphicsLineItem(x, 0, x, GameConfig::WINDOW_HEIGHT);
-        line->setPen(gridPen);
-        line->setZValue(-90);
-        gameScene->addItem(line);
-    }
-
-    // 绘制水平线
-    for (int y = 0; y <= GameConfig::WINDOW_HEIGHT; y += GameConfig::GRID_SIZE)
-    {
-        QGraphicsLineItem *line = new QGraphicsLineItem(0, y, GameConfig::WINDOW_WIDTH, y);
-        line->setPen(gridPen);
-        line->setZValue(-90);
-        gameScene->addItem(line);
-    }
-}
-
-void GamePage::initPlacementValidator()
-{
-    if (placementValidator) {
-        delete placementValidator;
-    }
-    placementValidator = new PlacementValidator();
-    placementValidator->loadConfig(GameConfig::Placement::BUILDABLE_MAP.value(currentMapId));
-    drawPlacementAreas();
-}
-
-void GamePage::drawPlacementAreas()
-{
-    qDeleteAll(placementAreaItems);
-    placementAreaItems.clear();
-
-    if (!gameScene || !placementValidator)
-        return;
-
-    const QSet<QPair<int, int>> &allowed = placementValidator->getAllowedGrids();
-    int gridSize = GameConfig::GRID_SIZE;
-
-    for (const auto &pair : allowed)
-    {
-        int gx = pair.first;
-        int gy = pair.second;
-        
-        QGraphicsRectItem *item = new QGraphicsRectItem(gx * gridSize, gy * gridSize, gridSize, gridSize);
-        // Visual style: Green border, slight green fill
-        item->setPen(QPen(QColor(0, 255, 0, 150), 2)); 
-        item->setBrush(QBrush(QColor(0, 255, 0, 20)));
-        item->setZValue(-40); // Above background/grid, below towers
-        gameScene->addItem(item);
-        placementAreaItems.append(item);
-    }
-}
-
-// AI-generated function
 void GamePage::showFloatingTip(const QString &text, const QPointF &scenePos, const QColor &color)
 {
     QGraphicsTextItem *tipItem = new QGraphicsTextItem(text);
@@ -545,27 +517,71 @@ void GamePage::showUpgradeEffect(const QPointF &scenePos)
     });
 }
 
-void GamePage::createPath()
+void GamePage::initProfilerOverlay()
 {
-    // 根据地图ID获取路径
-    QVector<GameConfig::GridPoint> gridPoints = GameConfig::MapPaths::PATH_MAP.value(currentMapId, GameConfig::MapPaths::MAP1_PATH);
-    
-    // 获取路径点
-    const qreal offset = GameConfig::GRID_SIZE / 2 - GameConfig::ENEMY_SIZE / 2;
-    for (const GameConfig::GridPoint &gridPoint : gridPoints)
+    profilerOverlay = new QLabel(this);
+    profilerOverlay->setGeometry(8, 372, 380, 220);
+    profilerOverlay->setFont(QFont("Consolas", 9));
+    profilerOverlay->setStyleSheet("background-color: rgba(0, 0, 0, 170); color: #7CFC00; padding: 6px;");
+    profilerOverlay->setAlignment(Qt::AlignLeft | Qt::AlignTop);
+    profilerOverlay->setAttribute(Qt::WA_TransparentForMouseEvents, true);
+    profilerOverlay->hide();
+
+    profilerRefreshTimer = new QTimer(this);
+    profilerRefreshTimer->setInterval(250);
+    connect(profilerRefreshTimer, &QTimer::timeout, this, &GamePage::refreshProfilerOverlay);
+
+    // F3 切换性能叠加层
+    QShortcut *toggleShortcut = new QShortcut(QKeySequence(Qt::Key_F3), this);
+    connect(toggleShortcut, &QShortcut::activated, this, &GamePage::toggleProfilerOverlay);
+
+    // F4 导出最近的时间线
+    QShortcut *traceShortcut = new QShortcut(QKeySequence(Qt::Key_F4), this);
+    connect(traceShortcut, &QShortcut::activated, this, &GamePage::dumpTrace);
+}
+
+void GamePage::toggleProfilerOverlay()
+{
+    if (!profilerOverlay)
+        return;
+
+    if (profilerOverlay->isVisible())
     {
-        qreal x = gridPoint.gridX * GameConfig::GRID_SIZE + offset;
-        qreal y = gridPoint.gridY * GameConfig::GRID_SIZE + offset;
-        pathPoints << QPointF(x, y);
+        profilerRefreshTimer->stop();
+        profilerOverlay->hide();
+        return;
     }
-    
-    // 获取终点信息
-    if (!gridPoints.isEmpty())
+
+    refreshProfilerOverlay();
+    profilerOverlay->show();
+    profilerOverlay->raise();
+    profilerRefreshTimer->start();
+}
+
+void GamePage::refreshProfilerOverlay()
+{
+    if (!profilerOverlay)
+        return;
+    profilerOverlay->setText(FrameProfiler::instance().overlayText());
+}
+
+void GamePage::dumpTrace()
+{
+    QString dirPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/traces";
+    QDir().mkpath(dirPath);
+    QString filePath = dirPath + QString("/trace-%1.json").arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss"));
+
+    QPointF tipPos(GameConfig::WINDOW_WIDTH / 2.0, GameConfig::WINDOW_HEIGHT / 2.0);
+    if (TraceRecorder::instance().writeChromeTrace(filePath))
     {
-        const GameConfig::GridPoint &lastPoint = gridPoints.last();
-        qreal centerX = lastPoint.gridX * GameConfig::GRID_SIZE + GameConfig::GRID_SIZE / 2;
-        qreal centerY = lastPoint.gridY * GameConfig::GRID_SIZE + GameConfig::GRID_SIZE / 2;
-        endPointAreas.append({centerX, centerY, GameConfig::GRID_SIZE / 2});
+        // 日志只记数值参数，文件名不进日志；文件在 AppDataLocation/traces 下按导出时间命名
+        LOG_INFO(CATEGORY_GAME, "Chrome trace written to AppDataLocation/traces");
+        showFloatingTip("时间线已导出", tipPos, Qt::green);
+    }
+    else
+    {
+        qWarning() << "[Trace] Failed to write" << filePath;
+        showFloatingTip("时间线导出失败", tipPos, Qt::red);
     }
 }
 
@@ -577,22 +593,7 @@ void GamePage::startGame()
     elapsedTimer.restart();
     pauseButton->setText("暂停");
     
-    // 确保GamePage及其所有子元素立即显示和更新
-    show();
-    update();
-    repaint();
-    if (gameView)
-    {
-        gameView->update();
-        gameView->repaint();
-        gameView->viewport()->update();
-        gameView->viewport()->repaint();
-    }
-    if (gameScene)
-    {
-        gameScene->update();
-    }
-    
+    // 不再强制同步重绘：场景变更会在下一轮事件循环里随首个模拟帧一起绘制
     gameManager->startGame();
 }
 
@@ -650,6 +651,22 @@ void GamePage::resetGame()
     updateGameStats();
 }
 
+void GamePage::restartLevel()
+{
+    if (!gameManager || !gameScene)
+        return;
+
+    // 只摘掉动态实体；静态底图与主角留在场景里，数值从开局快照整体还原
+    removeEntitiesFromScene(gameScene, gameManager->getEnemies());
+    removeEntitiesFromScene(gameScene, gameManager->getTowers());
+    removeEntitiesFromScene(gameScene, gameManager->getBullets());
+    removeEntitiesFromScene(gameScene, dyingEnemies);
+    dyingEnemies.clear();
+
+    gameManager->restoreSnapshot();
+    startGame();
+}
+
 // AI-generated function
 GamePage::ResultViewContext GamePage::createResultWrapper(const QString &panelStyle, const QColor &shadowColor)
 {
@@ -868,8 +885,7 @@ void GamePage::showGameOverDialog()
                     resultOverlay = nullptr;
                     resultPanel = nullptr;
                 }
-                resetGame();
-                startGame();
+                restartLevel();
             });
 
     connect(menuButton, &QPushButton::clicked, this, [this]()
@@ -1017,64 +1033,50 @@ void GamePage::showLevelCompleteDialog()
                     resultOverlay = nullptr;
                     resultPanel = nullptr;
                 }
-                resetGame();
-                startGame();
+                restartLevel();
             });
 
     resultOverlay->show();
     resultPanel->show();
 }
 
-void GamePage::saveLevelProgress(bool levelCompleted)
+void GamePage::autosave()
 {
-    if (!gameManager)
-        return;
-
-    int wave = gameManager->getCurrentWave();
+    QElapsedTimer timer;
+    timer.start();
+    QByteArray data = gameManager->saveState();
+    LOG_DEBUG(CATEGORY_GAME, "Autosave wave %1: %2 bytes serialized in %3 us",
+              gameManager->getCurrentWave(), data.size(), timer.nsecsElapsed() / 1000);
+    SaveGame::writeAutosaveAsync(data);
+}
 
-    // 使用组织名和应用名来初始化 QSettings
-    QSettings settings(GameConfig::ORG_NAME, GameConfig::APP_NAME);
+bool GamePage::resumeSavedGame(const QByteArray &data)
+{
+    GameConfig::MapId mapId = GameConfig::MAP1;
+    int wave = 1;
+    if (!GameManager::peekSave(data, &mapId, &wave))
+        return false;
 
-    QString mapKey = QString("levels/map_%1").arg(static_cast<int>(currentMapId));
-    int bestWave = settings.value(mapKey + "/bestWave", 0).toInt();
-    qDebug() << "[LevelProgress] Current wave:" << wave << "Best wave before:" << bestWave;
-    
-    if (wave > bestWave)
+    setMap(mapId);
+    if (!gameManager->loadState(data, gameScene, this))
     {
-        settings.setValue(mapKey + "/bestWave", wave);
-        qDebug() << "[LevelProgress] Update bestWave for" << mapKey << "to" << wave;
+        SaveGame::removeAutosaveAsync();
+        return false;
     }
+    startGame();
+    return true;
+}
 
-    if (levelCompleted)
-    {
-        int unlockedMaxIndex = settings.value("levels/unlocked_max_index", 0).toInt();
-        int currentIndex = static_cast<int>(currentMapId);
-        qDebug() << "[LevelProgress] levelCompleted on map index" << currentIndex
-                 << "current unlocked_max_index =" << unlockedMaxIndex;
+void GamePage::saveLevelProgress(bool levelCompleted)
+{
+    if (!gameManager)
+        return;
 
-        int nextIndex = currentIndex + 1;
-        int maxIndex = static_cast<int>(GameConfig::MAP2);
+    // 对局已结束，不再需要从自动存档继续
+    SaveGame::removeAutosaveAsync();
 
-        if (nextIndex <= maxIndex && nextIndex > unlockedMaxIndex)
-        {
-            settings.setValue("levels/unlocked_max_index", nextIndex);
-            qDebug() << "[LevelProgress] Unlock next level index" << nextIndex;
-        }
-        else
-        {
-            qDebug() << "[LevelProgress] No new level to unlock. nextIndex =" << nextIndex
-                     << "maxIndex =" << maxIndex;
-        }
-    }
-
-    // 立即同步数据到存储
-    settings.sync();
-    
-    // 验证数据是否正确保存
-    QSettings verifySettings(GameConfig::ORG_NAME, GameConfig::APP_NAME);
-    int verifyUnlocked = verifySettings.value("levels/unlocked_max_index", -1).toInt();
-    int verifyWave = verifySettings.value(QString("levels/map_%1").arg(static_cast<int>(currentMapId)) + "/bestWave", -1).toInt();
-    qDebug() << "[LevelProgress] Verify after save - unlocked_max_index:" << verifyUnlocked << "bestWave:" << verifyWave;
+    // 进度只写内存，磁盘写入在后台完成，结算弹窗无需等待
+    ProgressStore::instance().recordResult(currentMapId, gameManager->getCurrentWave(), levelCompleted);
 }
 
 void GamePage::mousePressEvent(QMouseEvent *event)
@@ -1097,9 +1099,10 @@ void GamePage::mousePressEvent(QMouseEvent *event)
     // 转换到场景坐标
     QPointF scenePos = gameView->mapToScene(viewGlobalPos);
 
-    qDebug() << "Mouse click - Widget pos:" << event->pos()
-             << "View pos:" << viewGlobalPos
-             << "Scene pos:" << scenePos;
+    LOG_DEBUG(CATEGORY_INPUT, "Mouse click - widget (%1, %2) view (%3, %4) scene (%5, %6)",
+              event->pos().x(), event->pos().y(),
+              viewGlobalPos.x(), viewGlobalPos.y(),
+              scenePos.x(), scenePos.y());
 
     // 计算网格位置（对齐到网格）
     int gridSize = GameConfig::GRID_SIZE;
@@ -1109,49 +1112,37 @@ void GamePage::mousePressEvent(QMouseEvent *event)
     // 确保在有效范围内
     if (gridX < 0 || gridY < 0 || gridX >= GameConfig::WINDOW_WIDTH || gridY >= GameConfig::WINDOW_HEIGHT)
     {
-        qDebug() << "Click outside valid area";
+        LOG_DEBUG(CATEGORY_INPUT, "Click outside valid area");
         return;
     }
 
-    // 检查是否在路径上（简化检查）
-    bool onPath = false;
-    for (const QPointF &point : pathPoints)
-    {
-        qreal dx = point.x() - scenePos.x();
-        qreal dy = point.y() - scenePos.y();
-        if (dx * dx + dy * dy < 900)
-        { // 30像素半径内
-            onPath = true;
-            break;
-        }
-    }
+    // 路径、可建造与已有塔都从占用网格直接读取
+    const OccupancyGrid &occupancy = gameManager->getOccupancy();
+    const int cellX = gridX / gridSize;
+    const int cellY = gridY / gridSize;
 
-    if (onPath)
+    if (occupancy.isPath(cellX, cellY))
     {
-        qDebug() << "Cannot build on path";
+        LOG_DEBUG(CATEGORY_INPUT, "Cannot build on path");
         return;
     }
 
     if (event->button() == Qt::LeftButton)
     {
-        // Check placement validity
-        if (placementValidator && !placementValidator->isPlacementAllowed(gridX, gridY))
+        bool towerExists = occupancy.isOccupied(cellX, cellY);
+        if (towerExists)
+        {
+            LOG_DEBUG(CATEGORY_INPUT, "Tower already exists at (%1, %2)", gridX, gridY);
+        }
+        else if (!occupancy.canBuild(cellX, cellY))
         {
              showFloatingTip("此处禁止放置!", scenePos, Qt::red);
              return;
         }
-
-        bool towerExists = false;
-        for (QPointer<Tower> tower : gameManager->getTowers())
+        else if (gameManager->wouldBlockPath(cellX, cellY))
         {
-            if (tower &&
-                qAbs(tower->x() - gridX) < gridSize / 2 &&
-                qAbs(tower->y() - gridY) < gridSize / 2)
-            {
-                towerExists = true;
-                qDebug() << "Tower already exists at (" << gridX << "," << gridY << ")";
-                break;
-            }
+            showFloatingTip("不能堵死敌人的路!", scenePos, Qt::red);
+            return;
         }
 
         if (!towerExists)
@@ -1159,7 +1150,7 @@ void GamePage::mousePressEvent(QMouseEvent *event)
             int cost = GameConfig::TowerStats::ARROW_COST;
             if (gameManager->getGold() < cost)
             {
-                qDebug() << "Not enough gold to build tower";
+                LOG_DEBUG(CATEGORY_INPUT, "Not enough gold to build tower");
                 showFloatingTip("金币不足!", scenePos, Qt::red);
                 QWidget::mousePressEvent(event);
                 return;
@@ -1190,21 +1181,11 @@ void GamePage::mousePressEvent(QMouseEvent *event)
     }
     else if (event->button() == Qt::RightButton)
     {
-        QList<QGraphicsItem *> itemsAtPos = gameScene->items(scenePos);
-        Tower *clickedTower = nullptr;
-        for (QGraphicsItem *item : itemsAtPos)
-        {
-            Tower *tower = dynamic_cast<Tower *>(item);
-            if (tower)
-            {
-                clickedTower = tower;
-                break;
-            }
-        }
+        Tower *clickedTower = occupancy.towerAt(cellX, cellY);
 
         if (!clickedTower)
         {
-            qDebug() << "Right click at empty grid (" << gridX << "," << gridY << ")";
+            LOG_DEBUG(CATEGORY_INPUT, "Right click at empty grid (%1, %2)", gridX, gridY);
             QWidget::mousePressEvent(event);
             return;
         }
@@ -1412,26 +1393,39 @@ void GamePage::updateHoverHighlight(const QPointF &scenePos)
         return;
     }
 
-    if (lastHighlight && gridX == lastGridX && gridY == lastGridY)
-        return;
-
-    if (lastHighlight)
+    // 空格子建不了塔（不可建造或会堵死道路）时标红；判定都是常数时间，可随鼠标实时刷新
+    bool blocked = false;
+    if (gameManager)
     {
-        gameScene->removeItem(lastHighlight);
-        delete lastHighlight;
-        lastHighlight = nullptr;
+        const OccupancyGrid &occupancy = gameManager->getOccupancy();
+        const int cellX = gridX / gridSize;
+        const int cellY = gridY / gridSize;
+        blocked = !occupancy.isOccupied(cellX, cellY) &&
+                  (!occupancy.canBuild(cellX, cellY) || gameManager->wouldBlockPath(cellX, cellY));
     }
+    const QColor tint = blocked ? QColor(255, 60, 60) : QColor(255, 255, 255);
 
-    lastHighlight = new QGraphicsRectItem(gridX, gridY, gridSize, gridSize);
-    lastHighlight->setBrush(QBrush(QColor(255, 255, 255, 30)));
-    lastHighlight->setPen(QPen(QColor(255, 255, 255, 100), 2));
-    lastHighlight->setZValue(1000);
-    gameScene->addItem(lastHighlight);
+    if (!lastHighlight || gridX != lastGridX || gridY != lastGridY)
+    {
+        if (lastHighlight)
+        {
+            gameScene->removeItem(lastHighlight);
+            delete lastHighlight;
+            lastHighlight = nullptr;
+        }
 
-    lastGridX = gridX;
-    lastGridY = gridY;
+        lastHighlight = new QGraphicsRectItem(gridX, gridY, gridSize, gridSize);
+        lastHighlight->setZValue(1000);
+        gameScene->addItem(lastHighlight);
+
+        lastGridX = gridX;
+        lastGridY = gridY;
+    }
 
-    qDebug() << "Hover highlight at grid (" << gridX << "," << gridY << ")";
+    lastHighlight->setBrush(QBrush(QColor(tint.red(), tint.green(), tint.blue(), blocked ? 60 : 30)));
+    lastHighlight->setPen(QPen(QColor(tint.red(), tint.green(), tint.blue(), blocked ? 160 : 100), 2));
+
+    LOG_TRACE(CATEGORY_INPUT, "Hover highlight at grid (%1, %2)", gridX, gridY);
 }
 
 // AI-generated function
@@ -1479,10 +1473,8 @@ void GamePage::pauseAllTowersAndBullets()
     }
 
     // 暂停所有子弹的移动
-    // 使用gameScene->items()查找所有Bullet对象
-    for (QGraphicsItem *item : gameScene->items())
+    for (QPointer<Bullet> bullet : gameManager->getBullets())
     {
-        Bullet *bullet = dynamic_cast<Bullet *>(item);
         if (bullet)
         {
             bullet->pauseMovement();
@@ -1505,10 +1497,8 @@ void GamePage::resumeAllTowersAndBullets()
     }
 
     // 恢复所有子弹的移动
-    // 使用gameScene->items()查找所有Bullet对象
-    for (QGraphicsItem *item : gameScene->items())
+    for (QPointer<Bullet> bullet : gameManager->getBullets())
     {
-        Bullet *bullet = dynamic_cast<Bullet *>(item);
         if (bullet)
         {
             bullet->resumeMovement();
@@ -1607,8 +1597,7 @@ void GamePage::showPauseMenu()
                     pauseOverlay = nullptr;
                     pausePanel = nullptr;
                 }
-                resetGame();
-                startGame();
+                restartLevel();
             });
 
     connect(exitButton, &QPushButton::clicked, this, [this]()
@@ -0,0 +1,13 @@
+#include "include/gameview.h"
+#include "include/frameprofiler.h"
+
+GameView::GameView(QWidget *parent)
+    : QGraphicsView(parent)
+{
+}
+
+void GameView::paintEvent(QPaintEvent *event)
+{
+    ScopedPhaseTimer phaseTimer(FrameProfiler::PHASE_PAINT);
+    QGraphicsView::paintEvent(event);
+}
@@ -0,0 +1,44 @@
+#include "include/lanepath.h"
+
+#include <algorithm>
+#include <cmath>
+
+LanePath::LanePath(const QVector<QPointF> &points)
+    : waypoints(points),
+      length(0)
+{
+    const int segments = qMax(0, points.size() - 1);
+    directions.reserve(segments);
+    segmentStarts.reserve(segments);
+    for (int i = 0; i < segments; ++i)
+    {
+        QPointF delta = points[i + 1] - points[i];
+        qreal segmentLength = std::sqrt(delta.x() * delta.x() + delta.y() * delta.y());
+        directions.append(segmentLength > 0 ? delta / segmentLength : QPointF());
+        segmentStarts.append(length);
+        length += segmentLength;
+    }
+}
+
+int LanePath::segmentAt(qreal distance) const
+{
+    if (segmentStarts.isEmpty())
+        return -1;
+
+    // 最后一个起点不超过 distance 的段；零长度段会被后一段覆盖
+    QVector<qreal>::const_iterator it = std::upper_bound(segmentStarts.constBegin(), segmentStarts.constEnd(), distance);
+    int segment = static_cast<int>(it - segmentStarts.constBegin()) - 1;
+    return qBound(0, segment, segmentStarts.size() - 1);
+}
+
+QPointF LanePath::pointAt(qreal distance) const
+{
+    if (segmentStarts.isEmpty())
+        return start();
+    if (distance >= length)
+        return waypoints.last();
+
+    int segment = segmentAt(distance);
+    qreal along = qMax<qreal>(0, distance - segmentStarts[segment]);
+    return waypoints[segment] + directions[segment] * along;
+}
@@ -0,0 +1,116 @@
+#include "include/levelpreloader.h"
+#include "include/gamemanager.h"
+#include "include/resourcemanager.h"
+#include "include/logger.h"
+
+#include <QPainter>
+#include <QPen>
+#include <QBrush>
+#include <QtConcurrent>
+
+LevelPreloader::LevelPreloader()
+    : QObject(nullptr)
+{
+}
+
+LevelPreloader &LevelPreloader::instance()
+{
+    static LevelPreloader instance;
+    return instance;
+}
+
+void LevelPreloader::prepareAsync(GameConfig::MapId mapId)
+{
+    if (prepared.contains(mapId) || inFlight.contains(mapId))
+        return;
+    inFlight.insert(mapId);
+
+    QtConcurrent::run([this, mapId]() {
+        PreparedLevel level = buildLevel(mapId);
+        QMetaObject::invokeMethod(this, [this, level]() {
+            inFlight.remove(level.mapId);
+            store(level);
+            emit levelPrepared(level.mapId);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void LevelPreloader::store(PreparedLevel level)
+{
+    // 期间已被同步构建过则保留先到的那份
+    if (prepared.contains(level.mapId))
+        return;
+    pixmaps.insert(level.mapId, QPixmap::fromImage(level.staticLayer));
+    // 贴图已持有像素，缓存里不再留一份图片
+    level.staticLayer = QImage();
+    prepared.insert(level.mapId, level);
+}
+
+PreparedLevel LevelPreloader::acquire(GameConfig::MapId mapId)
+{
+    if (!prepared.contains(mapId))
+    {
+        LOG_INFO(CATEGORY_GAME, "Map %1 not prepared yet, building synchronously", static_cast<int>(mapId));
+        store(buildLevel(mapId));
+    }
+    return prepared.value(mapId);
+}
+
+PreparedLevel LevelPreloader::buildLevel(GameConfig::MapId mapId)
+{
+    PreparedLevel level;
+    level.mapId = mapId;
+    level.lanePaths = GameManager::buildLanePaths(mapId);
+    level.endPoints = GameManager::buildEndPoints(mapId);
+    level.placement.loadConfig(GameConfig::Placement::BUILDABLE_MAP.value(mapId));
+    level.staticLayer = renderStaticLayer(mapId, level.placement);
+    return level;
+}
+
+QImage LevelPreloader::renderStaticLayer(GameConfig::MapId mapId, const PlacementValidator &placement)
+{
+    // 只用 QImage 与 QPainter，工作线程里不能碰 QPixmap
+    QImage layer(GameConfig::WINDOW_WIDTH, GameConfig::WINDOW_HEIGHT, QImage::Format_ARGB32_Premultiplied);
+    layer.fill(QColor(144, 238, 144));
+
+    QPainter painter(&layer);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+
+    // 地图背景，拉伸铺满窗口
+    QImage map(ResourceManager::mapResourcePath(mapId));
+    if (!map.isNull())
+        painter.drawImage(layer.rect(), map);
+
+    // 开阔地图没有画好的道路，只标出各路线的出生点与终点
+    if (GameConfig::MapPaths::OPEN_FIELD_MAPS.contains(mapId))
+    {
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(QColor(181, 137, 89));
+        for (const QVector<GameConfig::GridPoint> &lane : GameConfig::MapPaths::LANE_MAP.value(mapId))
+        {
+            if (lane.isEmpty())
+                continue;
+            for (const GameConfig::GridPoint &point : {lane.first(), lane.last()})
+                painter.drawRect(point.gridX * GameConfig::GRID_SIZE, point.gridY * GameConfig::GRID_SIZE,
+                                 GameConfig::GRID_SIZE, GameConfig::GRID_SIZE);
+        }
+    }
+
+    // 网格线
+    painter.setPen(QPen(QColor(200, 255, 200, 100), 1));
+    for (int x = 0; x <= GameConfig::WINDOW_WIDTH; x += GameConfig::GRID_SIZE)
+        painter.drawLine(x, 0, x, GameConfig::WINDOW_HEIGHT);
+    for (int y = 0; y <= GameConfig::WINDOW_HEIGHT; y += GameConfig::GRID_SIZE)
+        painter.drawLine(0, y, GameConfig::WINDOW_WIDTH, y);
+
+    // 可建造格：绿色边框与浅绿填充
+    const int gridSize = GameConfig::GRID_SIZE;
+    painter.setPen(QPen(QColor(0, 255, 0, 150), 2));
+    painter.setBrush(QBrush(QColor(0, 255, 0, 20)));
+    for (const auto &pair : placement.getAllowedGrids())
+        painter.drawRect(pair.first * gridSize, pair.second * gridSize, gridSize, gridSize);
+
+    painter.end();
+    return layer;
+}
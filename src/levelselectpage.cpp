@@ -1,14 +1,16 @@
 #include "include/levelselectpage.h"
 #include "include/resourcemanager.h"
+#include "include/levelpreloader.h"
+#include "include/progressstore.h"
 
 #include "ui_levelselectpage.h"
 
 #include <QPushButton>
 #include <QLabel>
 #include <QVBoxLayout>
+#include <QShowEvent>
 #include <QHBoxLayout>
 #include <QFont>
-#include <QSettings>
 #include <QDebug>
 
 LevelSelectPage::LevelSelectPage(QWidget *parent)
@@ -19,7 +21,11 @@ LevelSelectPage::LevelSelectPage(QWidget *parent)
       map2StatusLabel(nullptr),
       map1WaveLabel(nullptr),
       map2WaveLabel(nullptr),
-      map2Button(nullptr)
+      map3StatusLabel(nullptr),
+      map3WaveLabel(nullptr),
+      map2Button(nullptr),
+      map3Button(nullptr),
+      unlockedMaxIndex(0)
 {
     ui->setupUi(this);
 
@@ -27,6 +33,10 @@ LevelSelectPage::LevelSelectPage(QWidget *parent)
 
     initUI();
     loadProgress();
+
+    // 进度在内存中变化后直接刷新显示
+    connect(&ProgressStore::instance(), &ProgressStore::progressChanged,
+            this, &LevelSelectPage::loadProgress);
 }
 
 LevelSelectPage::~LevelSelectPage()
@@ -52,39 +62,69 @@ void LevelSelectPage::initUI()
     map1WaveLabel = ui->map1WaveLabel;
     map2WaveLabel = ui->map2WaveLabel;
     map2Button = ui->map2Button;
+    map3StatusLabel = ui->map3StatusLabel;
+    map3WaveLabel = ui->map3WaveLabel;
+    map3Button = ui->map3Button;
 
-    ResourceManager &rm2 = ResourceManager::instance();
-    if (ui->map1Preview)
+    // 预览图由资源预加载产出；尚未解码完成时先显示占位文字，送达后再填入
+    if (rm.isPreloadFinished())
     {
-        QPixmap map1Pixmap = rm2.getGameMap(GameConfig::MAP1).scaled(260, 180, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        ui->map1Preview->setPixmap(map1Pixmap);
+        showMapPreviews();
     }
-    if (ui->map2Preview)
+    else
     {
-        QPixmap map2Pixmap = rm2.getGameMap(GameConfig::MAP2).scaled(260, 180, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        ui->map2Preview->setPixmap(map2Pixmap);
+        if (ui->map1Preview)
+            ui->map1Preview->setText("加载中…");
+        if (ui->map2Preview)
+            ui->map2Preview->setText("加载中…");
+        connect(&rm, &ResourceManager::assetsReady, this, &LevelSelectPage::showMapPreviews);
     }
 
     if (ui->map1Button)
         connect(ui->map1Button, &QPushButton::clicked, this, &LevelSelectPage::onMap1Clicked);
     if (ui->map2Button)
         connect(ui->map2Button, &QPushButton::clicked, this, &LevelSelectPage::onMap2Clicked);
+    if (ui->map3Button)
+        connect(ui->map3Button, &QPushButton::clicked, this, &LevelSelectPage::onMap3Clicked);
     if (ui->cancelButton)
         connect(ui->cancelButton, &QPushButton::clicked, this, &LevelSelectPage::onCancelClicked);
 }
 
+void LevelSelectPage::showMapPreviews()
+{
+    ResourceManager &rm = ResourceManager::instance();
+    if (ui->map1Preview)
+        ui->map1Preview->setPixmap(rm.getMapPreview(GameConfig::MAP1));
+    if (ui->map2Preview)
+        ui->map2Preview->setPixmap(rm.getMapPreview(GameConfig::MAP2));
+}
+
+void LevelSelectPage::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+
+    // 玩家多半会点最新解锁的地图，先备它，再备其余已解锁地图
+    LevelPreloader &preloader = LevelPreloader::instance();
+    int latest = qBound(0, unlockedMaxIndex, GameConfig::MAP_COUNT - 1);
+    preloader.prepareAsync(static_cast<GameConfig::MapId>(latest));
+    for (int index = 0; index <= latest; ++index)
+        preloader.prepareAsync(static_cast<GameConfig::MapId>(index));
+}
+
 void LevelSelectPage::loadProgress()
 {
-    QSettings settings(GameConfig::ORG_NAME, GameConfig::APP_NAME);
+    ProgressStore &progress = ProgressStore::instance();
 
-    int unlockedMaxIndex = settings.value("levels/unlocked_max_index", 0).toInt();
+    unlockedMaxIndex = progress.unlockedMaxIndex();
 
-    int map1BestWave = settings.value("levels/map_0/bestWave", 0).toInt();
-    int map2BestWave = settings.value("levels/map_1/bestWave", 0).toInt();
+    int map1BestWave = progress.bestWave(GameConfig::MAP1);
+    int map2BestWave = progress.bestWave(GameConfig::MAP2);
+    int map3BestWave = progress.bestWave(GameConfig::MAP3);
 
     qDebug() << "[LevelSelect] unlocked_max_index =" << unlockedMaxIndex
              << "map1BestWave =" << map1BestWave
-             << "map2BestWave =" << map2BestWave;
+             << "map2BestWave =" << map2BestWave
+             << "map3BestWave =" << map3BestWave;
 
     if (map1StatusLabel)
         map1StatusLabel->setText("已解锁");
@@ -107,6 +147,20 @@ void LevelSelectPage::loadProgress()
 
     if (map2Button)
         map2Button->setEnabled(map2Unlocked);
+
+    bool map3Unlocked = unlockedMaxIndex >= 2;
+    if (map3StatusLabel)
+        map3StatusLabel->setText(map3Unlocked ? "已解锁" : "未解锁");
+    if (map3WaveLabel)
+    {
+        if (map3BestWave > 0)
+            map3WaveLabel->setText(QString("最高波次：第 %1 波").arg(map3BestWave));
+        else
+            map3WaveLabel->setText("最高波次：未挑战");
+    }
+
+    if (map3Button)
+        map3Button->setEnabled(map3Unlocked);
 }
 
 void LevelSelectPage::onMap1Clicked()
@@ -121,6 +175,12 @@ void LevelSelectPage::onMap2Clicked()
     emit startGameRequested(mapId);
 }
 
+void LevelSelectPage::onMap3Clicked()
+{
+    mapId = GameConfig::MAP3;
+    emit startGameRequested(mapId);
+}
+
 void LevelSelectPage::onCancelClicked()
 {
     emit returnToMainMenuRequested();
@@ -0,0 +1,83 @@
+#include "include/logger.h"
+
+#include <QDebug>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+Logger::Logger()
+    : flushCursor(0),
+      categoryMask(0xFFFFFFFFu)
+{
+    clock.start();
+}
+
+Logger &Logger::instance()
+{
+    static Logger logger;
+    return logger;
+}
+
+void Logger::setCategoryEnabled(Category category, bool enabled)
+{
+    quint32 bit = 1u << category;
+    if (enabled)
+        categoryMask.fetch_or(bit, std::memory_order_relaxed);
+    else
+        categoryMask.fetch_and(~bit, std::memory_order_relaxed);
+}
+
+const char *Logger::categoryName(Category category)
+{
+    switch (category)
+    {
+    case CATEGORY_GAME:
+        return "game";
+    case CATEGORY_TOWER:
+        return "tower";
+    case CATEGORY_BULLET:
+        return "bullet";
+    case CATEGORY_INPUT:
+        return "input";
+    default:
+        return "misc";
+    }
+}
+
+QString Logger::format(const Record &entry)
+{
+    QString text = QString::fromUtf8(entry.format);
+    for (int i = 0; i < entry.argCount; ++i)
+        text = text.arg(entry.args[i], 0, 'g', 8);
+
+    return QString("[%1 %2] %3")
+        .arg(entry.timestampNs / 1000000.0, 0, 'f', 3)
+        .arg(QString::fromLatin1(categoryName(static_cast<Category>(entry.category))))
+        .arg(text);
+}
+
+void Logger::flush()
+{
+    QVector<Record> pending;
+    flushCursor = records.snapshot(pending, flushCursor);
+
+    for (const Record &entry : pending)
+    {
+        QString line = format(entry);
+        if (entry.level >= LEVEL_WARN)
+            qWarning().noquote() << line;
+        else if (entry.level >= LEVEL_INFO)
+            qInfo().noquote() << line;
+        else
+            qDebug().noquote() << line;
+    }
+}
+
+void Logger::startFlushTimer(QObject *owner, int intervalMs)
+{
+    QTimer *timer = new QTimer(owner);
+    QObject::connect(timer, &QTimer::timeout, []() {
+        Logger::instance().flush();
+    });
+    timer->start(intervalMs);
+}
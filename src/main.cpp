@@ -1,23 +1,65 @@
 #include "include/mainwindow.h"
 #include "include/config.h"
+#include "include/logger.h"
+#include "include/resourcemanager.h"
+#include "include/startuptimeline.h"
+#include "include/progressstore.h"
+#include "include/targetingindex.h"
 
 #include <QApplication>
 #include <QCoreApplication>
 #include <QDebug>
+#include <QtConcurrent>
 
 int main(int argc, char *argv[])
 {
+    StartupTimeline &timeline = StartupTimeline::instance();
+    timeline.mark("main_enter");
+
     QApplication a(argc, argv);
+    timeline.mark("qapplication_ready");
 
     // 设置应用程序信息（用于 QSettings 存储路径）
     QCoreApplication::setOrganizationName(GameConfig::ORG_NAME);
     QCoreApplication::setApplicationName(GameConfig::APP_NAME);
 
+    // 热路径日志以二进制写入环形缓冲，由定时器在主循环空闲时统一格式化输出
+    Logger::instance().startFlushTimer(&a);
+    QObject::connect(&a, &QCoreApplication::aboutToQuit, []() {
+        Logger::instance().flush();
+        // 等最后一次进度写盘落地
+        ProgressStore::instance().waitForPendingWrites();
+        // 音频线程须在应用对象销毁前结束
+        ResourceManager::instance().stopAudio();
+    });
+
     qDebug() << "Application starting...";
 
     MainWindow w;
+    timeline.mark("mainwindow_ready");
     qDebug() << "MainWindow created, showing...";
     w.show();
+    timeline.mark("window_shown");
+
+    // 首帧绘制后再在线程池里解码图片与音效，菜单显示不再等待资源
+    QObject::connect(&timeline, &StartupTimeline::finished, []() {
+        ResourceManager::instance().preloadAssetsAsync();
+    });
+
+    // 索敌实现的切换阈值按本机实测；等资源解码全部结束再测，避免与解码任务争抢核心
+    QObject::connect(&ResourceManager::instance(), &ResourceManager::assetsReady, []() {
+        QtConcurrent::run([]() {
+            TargetingIndex::calibrate();
+        });
+    });
+
+    // --startup-check：首帧后立即退出，超出预算时返回非零，供回归检查使用
+    if (a.arguments().contains(QStringLiteral("--startup-check")))
+    {
+        QObject::connect(&timeline, &StartupTimeline::finished, &a, [&timeline]() {
+            QCoreApplication::exit(timeline.withinBudget() ? 0 : 1);
+        }, Qt::QueuedConnection);
+    }
 
     qDebug() << "Application running";
     return a.exec();
@@ -10,10 +10,12 @@
 #include <QFont>
 #include <QSpacerItem>
 #include <QApplication>
+#include <QProgressBar>
 
 MainMenuPage::MainMenuPage(QWidget *parent)
     : QWidget(parent),
-      ui(new Ui::MainMenuPage)
+      ui(new Ui::MainMenuPage),
+      loadingBar(nullptr)
 {
     ui->setupUi(this);
     initUI();
@@ -51,6 +53,25 @@ void MainMenuPage::initUI()
         connect(startButton, &QPushButton::clicked, this, &MainMenuPage::onStartButtonClicked);
     if (exitButton)
         connect(exitButton, &QPushButton::clicked, this, &MainMenuPage::onExitButtonClicked);
+
+    // 底部细进度条：菜单先显示，资源在后台解码完成后自动隐藏
+    loadingBar = new QProgressBar(this);
+    loadingBar->setTextVisible(false);
+    loadingBar->setRange(0, 0);
+    loadingBar->setGeometry(0, GameConfig::WINDOW_HEIGHT - 4, GameConfig::WINDOW_WIDTH, 4);
+    loadingBar->setStyleSheet("QProgressBar { border: none; background: rgba(0, 0, 0, 60); }"
+                              "QProgressBar::chunk { background: #FF8C00; }");
+    loadingBar->setVisible(!rm.isPreloadFinished());
+    connect(&rm, &ResourceManager::loadProgress, this, &MainMenuPage::onLoadProgress);
+    connect(&rm, &ResourceManager::assetsReady, loadingBar, &QProgressBar::hide);
+}
+
+void MainMenuPage::onLoadProgress(int loaded, int total)
+{
+    if (!loadingBar || total <= 0)
+        return;
+    loadingBar->setRange(0, total);
+    loadingBar->setValue(loaded);
 }
 
 void MainMenuPage::loadResources()
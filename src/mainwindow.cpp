@@ -3,6 +3,9 @@
 #include "include/gamepage.h"
 #include "include/mainmenupage.h"
 #include "include/levelselectpage.h"
+#include "include/startuptimeline.h"
+#include "include/savegame.h"
+#include "include/gamemanager.h"
 
 #include <QStackedWidget>
 #include <QVBoxLayout>
@@ -11,6 +14,8 @@
 #include <QEasingCurve>
 #include <QSettings>
 #include <QApplication>
+#include <QTimer>
+#include <QMessageBox>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent), stackedWidget(nullptr), gamePage(nullptr), mainMenuPage(nullptr), levelSelectPage(nullptr)
@@ -30,48 +35,108 @@ MainWindow::MainWindow(QWidget *parent)
 
     setCentralWidget(central);
 
+    // 启动时只建主菜单；关卡选择与游戏页面在首次导航或空闲预建时创建
     mainMenuPage = new MainMenuPage(this);
-    levelSelectPage = new LevelSelectPage(this);
-    gamePage = new GamePage(this);
-
     stackedWidget->addWidget(mainMenuPage);
-    stackedWidget->addWidget(levelSelectPage);
-    stackedWidget->addWidget(gamePage);
     stackedWidget->setCurrentWidget(mainMenuPage);
 
     connect(mainMenuPage, &MainMenuPage::openLevelSelectRequested,
-            this, [this]() {
-                if (stackedWidget)
-                    stackedWidget->setCurrentIndex(1);
-            });
+            this, &MainWindow::switchToLevelSelect);
     connect(mainMenuPage, &MainMenuPage::exitGameRequested,
             this, &QApplication::quit);
+
+    // 主菜单首帧画出后再利用空闲时间预建其余页面
+    StartupTimeline &timeline = StartupTimeline::instance();
+    timeline.markOnFirstPaint(mainMenuPage, "menu_first_paint");
+    connect(&timeline, &StartupTimeline::finished,
+            this, &MainWindow::prebuildPagesWhenIdle);
+
+    setWindowTitle("塔之进化 - TowerEvolution");
+    resize(GameConfig::WINDOW_WIDTH, GameConfig::WINDOW_HEIGHT);
+}
+
+MainWindow::~MainWindow()
+{
+}
+
+LevelSelectPage *MainWindow::ensureLevelSelectPage()
+{
+    if (levelSelectPage)
+        return levelSelectPage;
+
+    levelSelectPage = new LevelSelectPage(this);
+    stackedWidget->addWidget(levelSelectPage);
     connect(levelSelectPage, &LevelSelectPage::startGameRequested,
             this, &MainWindow::switchToGamePage);
     connect(levelSelectPage, &LevelSelectPage::returnToMainMenuRequested,
             this, &MainWindow::switchToMainMenu);
+    return levelSelectPage;
+}
+
+GamePage *MainWindow::ensureGamePage()
+{
+    if (gamePage)
+        return gamePage;
+
+    gamePage = new GamePage(this);
+    stackedWidget->addWidget(gamePage);
     connect(gamePage, &GamePage::returnToMainMenu,
             this, &MainWindow::switchToMainMenu);
     connect(gamePage, &GamePage::gameOver,
             this, &MainWindow::onGameOver);
-
-    setWindowTitle("塔之进化 - TowerEvolution");
-    resize(GameConfig::WINDOW_WIDTH, GameConfig::WINDOW_HEIGHT);
+    return gamePage;
 }
 
-MainWindow::~MainWindow()
+void MainWindow::prebuildPagesWhenIdle()
 {
+    // 每轮事件循环只建一个页面，避免长时间占住 GUI 线程
+    QTimer::singleShot(0, this, [this]() {
+        if (!levelSelectPage)
+        {
+            ensureLevelSelectPage();
+            prebuildPagesWhenIdle();
+            return;
+        }
+        if (!gamePage)
+            ensureGamePage();
+    });
 }
 
-void MainWindow::switchToGamePage(GameConfig::MapId mapId)
+void MainWindow::switchToLevelSelect()
 {
-    if (stackedWidget)
-        stackedWidget->setCurrentIndex(2);
-    if (gamePage)
+    // 上次对局未正常结束（退出或崩溃）时先询问是否继续
+    if (SaveGame::hasAutosave())
     {
-        gamePage->setMap(mapId);
-        gamePage->startGame();
+        QByteArray data = SaveGame::readAutosave();
+        GameConfig::MapId mapId = GameConfig::MAP1;
+        int wave = 1;
+        if (GameManager::peekSave(data, &mapId, &wave))
+        {
+            QMessageBox::StandardButton answer = QMessageBox::question(
+                this, "继续游戏",
+                QString("发现未完成的对局（地图 %1，第 %2 波），是否继续？")
+                    .arg(static_cast<int>(mapId) + 1)
+                    .arg(wave));
+            if (answer == QMessageBox::Yes)
+            {
+                GamePage *page = ensureGamePage();
+                stackedWidget->setCurrentWidget(page);
+                if (page->resumeSavedGame(data))
+                    return;
+            }
+        }
+        SaveGame::removeAutosaveAsync();
     }
+
+    stackedWidget->setCurrentWidget(ensureLevelSelectPage());
+}
+
+void MainWindow::switchToGamePage(GameConfig::MapId mapId)
+{
+    GamePage *page = ensureGamePage();
+    stackedWidget->setCurrentWidget(page);
+    page->setMap(mapId);
+    page->startGame();
 }
 
 void MainWindow::switchToMainMenu()
@@ -83,7 +148,7 @@ void MainWindow::switchToMainMenu()
         gamePage->resetGame();
     }
     if (stackedWidget)
-        stackedWidget->setCurrentIndex(0);
+        stackedWidget->setCurrentWidget(mainMenuPage);
 }
 
 void MainWindow::onGameOver()
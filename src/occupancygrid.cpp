@@ -0,0 +1,112 @@
+#include "include/occupancygrid.h"
+#include "include/tower.h"
+
+OccupancyGrid::OccupancyGrid()
+    : cols(GameConfig::WINDOW_WIDTH / GameConfig::GRID_SIZE),
+      rowCount(GameConfig::WINDOW_HEIGHT / GameConfig::GRID_SIZE),
+      cells(cols * rowCount, 0),
+      towers(cols * rowCount)
+{
+}
+
+OccupancyGrid OccupancyGrid::buildForMap(GameConfig::MapId mapId)
+{
+    OccupancyGrid grid;
+    const QVector<QVector<GameConfig::GridPoint>> lanes = GameConfig::MapPaths::LANE_MAP.value(mapId);
+    const bool openField = GameConfig::MapPaths::OPEN_FIELD_MAPS.contains(mapId);
+
+    if (openField)
+    {
+        // 开阔地图：控制面板以下整片场地可建塔，只有出生点与终点是路径
+        for (int y = GameConfig::MapPaths::OPEN_FIELD_TOP_ROW; y < grid.rowCount; ++y)
+        {
+            for (int x = 0; x < grid.cols; ++x)
+                grid.cells[grid.index(x, y)] |= CELL_BUILDABLE;
+        }
+    }
+    else
+    {
+        for (const GameConfig::GridPoint &point : GameConfig::Placement::BUILDABLE_MAP.value(mapId))
+        {
+            if (grid.contains(point.gridX, point.gridY))
+                grid.cells[grid.index(point.gridX, point.gridY)] |= CELL_BUILDABLE;
+        }
+    }
+
+    for (const QVector<GameConfig::GridPoint> &path : lanes)
+    {
+        if (path.isEmpty())
+            continue;
+
+        if (openField)
+        {
+            grid.markPathSegment(path.first(), path.first());
+            grid.markPathSegment(path.last(), path.last());
+        }
+        else
+        {
+            for (int i = 1; i < path.size(); ++i)
+                grid.markPathSegment(path[i - 1], path[i]);
+            if (path.size() == 1)
+                grid.markPathSegment(path[0], path[0]);
+        }
+
+        const GameConfig::GridPoint &end = path.last();
+        if (grid.contains(end.gridX, end.gridY))
+            grid.cells[grid.index(end.gridX, end.gridY)] |= CELL_END;
+    }
+
+    return grid;
+}
+
+Tower *OccupancyGrid::towerAt(int cellX, int cellY) const
+{
+    return contains(cellX, cellY) ? towers[index(cellX, cellY)].data() : nullptr;
+}
+
+void OccupancyGrid::setTower(int cellX, int cellY, Tower *tower)
+{
+    if (!contains(cellX, cellY))
+        return;
+
+    int i = index(cellX, cellY);
+    towers[i] = tower;
+    if (tower)
+        cells[i] |= CELL_OCCUPIED;
+    else
+        cells[i] &= ~CELL_OCCUPIED;
+}
+
+void OccupancyGrid::clearTower(int cellX, int cellY)
+{
+    setTower(cellX, cellY, nullptr);
+}
+
+void OccupancyGrid::clearTowers()
+{
+    for (int i = 0; i < cells.size(); ++i)
+    {
+        cells[i] &= ~CELL_OCCUPIED;
+        towers[i].clear();
+    }
+}
+
+void OccupancyGrid::markPathSegment(const GameConfig::GridPoint &from, const GameConfig::GridPoint &to)
+{
+    // 路径配置只有拐点，相邻拐点总在同一行或同一列
+    int stepX = (to.gridX > from.gridX) - (to.gridX < from.gridX);
+    int stepY = (to.gridY > from.gridY) - (to.gridY < from.gridY);
+    int x = from.gridX;
+    int y = from.gridY;
+    while (true)
+    {
+        if (contains(x, y))
+            cells[index(x, y)] |= CELL_PATH;
+        if (x == to.gridX && y == to.gridY)
+            break;
+        if (x != to.gridX)
+            x += stepX;
+        else
+            y += stepY;
+    }
+}
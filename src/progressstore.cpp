@@ -0,0 +1,182 @@
+#include "include/progressstore.h"
+#include "include/logger.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QtConcurrent>
+#include <QDebug>
+#include <atomic>
+
+namespace
+{
+    const quint32 PROGRESS_MAGIC = 0x54455052; // "TEPR"
+    const quint16 PROGRESS_VERSION = 1;
+
+    // 与自动存档相同的做法：只有最新提交的快照才能落盘
+    std::atomic<quint64> submittedSequence(0);
+    quint64 completedSequence = 0;
+    QMutex fileMutex;
+}
+
+ProgressStore &ProgressStore::instance()
+{
+    static ProgressStore store;
+    return store;
+}
+
+ProgressStore::ProgressStore()
+    : QObject(nullptr),
+      unlockedMax(0)
+{
+    load();
+}
+
+QString ProgressStore::progressPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/progress.dat";
+}
+
+void ProgressStore::recordResult(GameConfig::MapId mapId, int wave, bool levelCompleted)
+{
+    bool changed = false;
+
+    if (wave > bestWave(mapId))
+    {
+        bestWaves.insert(mapId, wave);
+        changed = true;
+    }
+
+    if (levelCompleted)
+    {
+        int nextIndex = static_cast<int>(mapId) + 1;
+        if (nextIndex < GameConfig::MAP_COUNT && nextIndex > unlockedMax)
+        {
+            unlockedMax = nextIndex;
+            changed = true;
+        }
+    }
+
+    LOG_DEBUG(CATEGORY_GAME, "Progress map %1 wave %2 completed %3 -> best %4 unlocked %5",
+              static_cast<int>(mapId), wave, levelCompleted, bestWave(mapId), unlockedMax);
+
+    if (!changed)
+        return;
+
+    submitWrite();
+    emit progressChanged();
+}
+
+void ProgressStore::waitForPendingWrites()
+{
+    lastWrite.waitForFinished();
+}
+
+void ProgressStore::load()
+{
+    QByteArray data;
+    {
+        QMutexLocker locker(&fileMutex);
+        QFile file(progressPath());
+        if (file.open(QIODevice::ReadOnly))
+            data = file.readAll();
+    }
+
+    if (!data.isEmpty() && deserialize(data))
+        return;
+
+    // 首次运行新版本：沿用旧版 QSettings 中的进度，并立即写出新格式
+    loadLegacySettings();
+    if (unlockedMax > 0 || !bestWaves.isEmpty())
+        submitWrite();
+}
+
+void ProgressStore::loadLegacySettings()
+{
+    QSettings settings(GameConfig::ORG_NAME, GameConfig::APP_NAME);
+    unlockedMax = settings.value("levels/unlocked_max_index", 0).toInt();
+    for (int index = 0; index < GameConfig::MAP_COUNT; ++index)
+    {
+        int wave = settings.value(QString("levels/map_%1/bestWave").arg(index), 0).toInt();
+        if (wave > 0)
+            bestWaves.insert(static_cast<GameConfig::MapId>(index), wave);
+    }
+}
+
+QByteArray ProgressStore::serialize() const
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+    out.setByteOrder(QDataStream::LittleEndian);
+
+    out << PROGRESS_MAGIC << PROGRESS_VERSION;
+    out << static_cast<qint32>(unlockedMax);
+    out << static_cast<qint32>(bestWaves.size());
+    for (auto it = bestWaves.constBegin(); it != bestWaves.constEnd(); ++it)
+        out << static_cast<qint32>(it.key()) << static_cast<qint32>(it.value());
+    return data;
+}
+
+bool ProgressStore::deserialize(const QByteArray &data)
+{
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_5_12);
+    in.setByteOrder(QDataStream::LittleEndian);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (magic != PROGRESS_MAGIC || version != PROGRESS_VERSION)
+    {
+        qWarning() << "[Progress] Unrecognized progress file, falling back to settings";
+        return false;
+    }
+
+    qint32 unlocked = 0;
+    qint32 count = 0;
+    in >> unlocked >> count;
+    if (in.status() != QDataStream::Ok || count < 0 || count > 64)
+        return false;
+
+    QMap<GameConfig::MapId, int> waves;
+    for (int i = 0; i < count; ++i)
+    {
+        qint32 mapIndex = 0;
+        qint32 wave = 0;
+        in >> mapIndex >> wave;
+        waves.insert(static_cast<GameConfig::MapId>(mapIndex), wave);
+    }
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    unlockedMax = unlocked;
+    bestWaves = waves;
+    return true;
+}
+
+void ProgressStore::submitWrite()
+{
+    // 快照在 GUI 线程上序列化，几十字节，不涉及磁盘
+    QByteArray data = serialize();
+    quint64 sequence = submittedSequence.fetch_add(1) + 1;
+    QString path = progressPath();
+
+    lastWrite = QtConcurrent::run([data, sequence, path]() {
+        QMutexLocker locker(&fileMutex);
+        if (sequence < completedSequence)
+            return;
+        completedSequence = sequence;
+
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit())
+            qWarning() << "[Progress] Failed to write" << path;
+    });
+}
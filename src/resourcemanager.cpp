@@ -1,19 +1,66 @@
 #include "include/resourcemanager.h"
 #include "include/config.h"
+#include "include/audiomixer.h"
+#include "include/logger.h"
 
 #include <QPainter>
 #include <QPen>
 #include <QBrush>
-#include <QDebug>
 #include <QRandomGenerator>
-#include <QSoundEffect>
-#include <QUrl>
+#include <QImage>
+#include <QtConcurrent>
+#include <cmath>
+
+namespace
+{
+    // 关卡选择页的地图预览尺寸
+    const int MAP_PREVIEW_WIDTH = 260;
+    const int MAP_PREVIEW_HEIGHT = 180;
+
+    // 优先级越高越不容易被抢占；限频间隔避免同一音效在同一瞬间叠加
+    struct SoundSpec
+    {
+        const char *soundId;
+        int priority;
+        int minIntervalMs;
+    };
+    const SoundSpec SOUND_SPECS[] = {
+        {"coin", 3, 60},
+        {"hurt", 2, 40},
+        {"shoot_cannon", 1, 80},
+        {"shoot_magic", 1, 80},
+        {"shoot_arrow", 0, 50},
+    };
+
+    QString soundResourcePath(const QString &soundId)
+    {
+        return QStringLiteral(":/sound/sound/") + soundId + QStringLiteral(".wav");
+    }
+
+    QString mapKey(GameConfig::MapId mapId)
+    {
+        return QString("map_%1").arg(static_cast<int>(mapId));
+    }
+
+    QString mapPreviewKey(GameConfig::MapId mapId)
+    {
+        return QString("map_preview_%1").arg(static_cast<int>(mapId));
+    }
+}
 
 ResourceManager::ResourceManager(QObject *parent)
-    : QObject(parent)
+    : QObject(parent),
+      audioMixer(new AudioMixer(this)),
+      soundEnabled(true),
+      soundsLoaded(false),
+      soundBatchDepth(0),
+      preloadStarted(false),
+      assetsTotal(0),
+      assetsLoaded(0),
+      soundsPending(0)
 {
+    // 占位图只是几笔绘制，保持同步；真正的图片与音效解码交给 preloadAssetsAsync
     loadDefaultPixmaps();
-    preloadDefaultSounds();
 }
 
 ResourceManager& ResourceManager::instance()
@@ -41,22 +88,11 @@ QPixmap ResourceManager::getEnemyPixmap(int enemyType, EnemyState state) const
         return getDefaultEnemyPixmap();
     }
 
-    QString stateName;
-    switch (state) {
-        case ENEMY_IDLE:
-            stateName = "idle";
-            break;
-        case ENEMY_WALK:
-            stateName = "walk";
-            break;
-        case ENEMY_JUMP:
-            stateName = "jump";
-            break;
-        case ENEMY_DEAD:
-            stateName = "dead";
-            break;
-        default:
-            stateName = "idle";
+    QString stateName = enemyStateName(state);
+    QString cacheKey = QString("enemy_%1_%2").arg(type).arg(stateName);
+    if (pixmapCache.contains(cacheKey))
+    {
+        return pixmapCache.value(cacheKey);
     }
 
     // 路径格式: :/image/enemy/image/enemy_{type}_{state}.png
@@ -75,7 +111,25 @@ QPixmap ResourceManager::getEnemyPixmap(int enemyType, EnemyState state) const
         return getDefaultEnemyPixmap();
     }
 
-    return pixmap.scaled(GameConfig::ENEMY_SIZE, GameConfig::ENEMY_SIZE, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    pixmap = pixmap.scaled(GameConfig::ENEMY_SIZE, GameConfig::ENEMY_SIZE, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    pixmapCache.insert(cacheKey, pixmap);
+    return pixmap;
+}
+
+QString ResourceManager::enemyStateName(EnemyState state)
+{
+    switch (state) {
+        case ENEMY_IDLE:
+            return "idle";
+        case ENEMY_WALK:
+            return "walk";
+        case ENEMY_JUMP:
+            return "jump";
+        case ENEMY_DEAD:
+            return "dead";
+        default:
+            return "idle";
+    }
 }
 
 QPixmap ResourceManager::getUserPixmap(UserState state) const
@@ -94,6 +148,12 @@ QPixmap ResourceManager::getUserPixmap(UserState state) const
         break;
     }
 
+    QString cacheKey = QString("user_%1").arg(stateName);
+    if (pixmapCache.contains(cacheKey))
+    {
+        return pixmapCache.value(cacheKey);
+    }
+
     QString resourcePath = QString(":/image/user/image/user_%1.png").arg(stateName);
     QPixmap pixmap(resourcePath);
 
@@ -102,10 +162,12 @@ QPixmap ResourceManager::getUserPixmap(UserState state) const
         return getDefaultUserPixmap();
     }
 
-    return pixmap.scaled(GameConfig::ENEMY_SIZE,
-                         GameConfig::ENEMY_SIZE,
-                         Qt::KeepAspectRatio,
-                         Qt::SmoothTransformation);
+    pixmap = pixmap.scaled(GameConfig::ENEMY_SIZE,
+                           GameConfig::ENEMY_SIZE,
+                           Qt::KeepAspectRatio,
+                           Qt::SmoothTransformation);
+    pixmapCache.insert(cacheKey, pixmap);
+    return pixmap;
 }
 
 QPixmap ResourceManager::getDefaultEnemyPixmap() const
@@ -225,34 +287,59 @@ QPixmap ResourceManager::getGameMap() const
     return getGameMap(GameConfig::MAP1);
 }
 
-QPixmap ResourceManager::getGameMap(GameConfig::MapId mapId) const
+QString ResourceManager::mapResourcePath(GameConfig::MapId mapId)
 {
-    QString resourcePath;
-
     switch (mapId)
     {
-    case GameConfig::MAP1:
-        resourcePath = ":/image/map/image/map1.png";
-        break;
     case GameConfig::MAP2:
-        resourcePath = ":/image/map/image/map2.png";
-        break;
+        return QStringLiteral(":/image/map/image/map2.png");
+    case GameConfig::MAP3:
+        // 开阔地图没有底图，由关卡预备时画纯色场地
+        return QString();
+    case GameConfig::MAP1:
     default:
-        resourcePath = ":/image/map/image/map1.png";
-        break;
+        return QStringLiteral(":/image/map/image/map1.png");
     }
+}
 
-    QPixmap mapPixmap(resourcePath);
+QPixmap ResourceManager::getGameMap(GameConfig::MapId mapId) const
+{
+    QString cacheKey = mapKey(mapId);
+    if (pixmapCache.contains(cacheKey))
+    {
+        return pixmapCache.value(cacheKey);
+    }
+
+    QPixmap mapPixmap(mapResourcePath(mapId));
 
     if (mapPixmap.isNull())
     {
         return getDefaultBackground();
     }
 
-    return mapPixmap.scaled(GameConfig::WINDOW_WIDTH,
-                            GameConfig::WINDOW_HEIGHT,
-                            Qt::IgnoreAspectRatio,
-                            Qt::SmoothTransformation);
+    mapPixmap = mapPixmap.scaled(GameConfig::WINDOW_WIDTH,
+                                 GameConfig::WINDOW_HEIGHT,
+                                 Qt::IgnoreAspectRatio,
+                                 Qt::SmoothTransformation);
+    pixmapCache.insert(cacheKey, mapPixmap);
+    return mapPixmap;
+}
+
+QPixmap ResourceManager::getMapPreview(GameConfig::MapId mapId) const
+{
+    QString cacheKey = mapPreviewKey(mapId);
+    if (pixmapCache.contains(cacheKey))
+    {
+        return pixmapCache.value(cacheKey);
+    }
+
+    // 预加载尚未送达时现场缩放一次并缓存
+    QPixmap preview = getGameMap(mapId).scaled(MAP_PREVIEW_WIDTH,
+                                               MAP_PREVIEW_HEIGHT,
+                                               Qt::KeepAspectRatio,
+                                               Qt::SmoothTransformation);
+    pixmapCache.insert(cacheKey, preview);
+    return preview;
 }
 
 QPixmap ResourceManager::getBulletPixmap() const
@@ -448,59 +535,255 @@ void ResourceManager::loadDefaultPixmaps()
     pixmapCache["bullet_default"] = bulletPixmap;
 }
 
-QSoundEffect* ResourceManager::acquireSoundEffect(const QString &soundId)
+void ResourceManager::playSound(const QString &soundId, qreal volume, bool loop)
 {
-    QList<QSoundEffect*> &pool = soundEffectPool[soundId];
-    for (QSoundEffect *effect : pool)
+    if (!soundEnabled)
+        return;
+
+    if (soundBatchDepth == 0)
+    {
+        playSoundNow(soundId, qBound<qreal>(0.0, volume, 1.0), loop);
+        return;
+    }
+
+    // 批处理期间只记录次数与最大音量
+    QHash<QString, PendingSound>::iterator it = pendingSounds.find(soundId);
+    if (it == pendingSounds.end())
+    {
+        PendingSound pending = {1, volume, loop};
+        pendingSounds.insert(soundId, pending);
+        return;
+    }
+    it->count++;
+    it->maxVolume = qMax(it->maxVolume, volume);
+    it->loop = it->loop || loop;
+}
+
+void ResourceManager::beginSoundBatch()
+{
+    soundBatchDepth++;
+}
+
+void ResourceManager::flushSoundBatch()
+{
+    if (soundBatchDepth > 0)
+        soundBatchDepth--;
+    if (soundBatchDepth > 0 || pendingSounds.isEmpty())
+        return;
+
+    // 每种音效只发声一次，数量越多音量越大（按对数增长并封顶）
+    for (QHash<QString, PendingSound>::const_iterator it = pendingSounds.constBegin();
+         it != pendingSounds.constEnd(); ++it)
+    {
+        const PendingSound &pending = it.value();
+        qreal boost = 1.0 + GameConfig::SOUND_BATCH_VOLUME_STEP * std::log2(static_cast<qreal>(pending.count));
+        qreal volume = qBound<qreal>(0.0, pending.maxVolume * boost, GameConfig::SOUND_BATCH_MAX_VOLUME);
+        playSoundNow(it.key(), volume, pending.loop);
+    }
+    pendingSounds.clear();
+}
+
+void ResourceManager::stopAudio()
+{
+    audioMixer->stop();
+}
+
+void ResourceManager::playSoundNow(const QString &soundId, qreal volume, bool loop)
+{
+    // 音效表在音频线程启动后只读：异步解码未完成前直接丢弃本次音效
+    if (soundsPending > 0)
+        return;
+    if (!soundsLoaded)
+        preloadDefaultSounds();
+
+    // 首次发声时才启动音频线程；之后 play 只是向队列投递命令，不会阻塞
+    audioMixer->start();
+    audioMixer->play(soundId, volume, loop);
+}
+
+void ResourceManager::preloadDefaultSounds()
+{
+    for (const SoundSpec &spec : SOUND_SPECS)
+    {
+        QString soundId = QString::fromLatin1(spec.soundId);
+        audioMixer->loadClip(soundId, soundResourcePath(soundId), spec.priority, spec.minIntervalMs);
+    }
+    soundsLoaded = true;
+}
+
+QList<ResourceManager::ImageJob> ResourceManager::buildImageJobs() const
+{
+    QList<ImageJob> jobs;
+    const QSize enemySize(GameConfig::ENEMY_SIZE, GameConfig::ENEMY_SIZE);
+    const QSize gridSize(GameConfig::GRID_SIZE, GameConfig::GRID_SIZE);
+
+    // 敌人与主角：与 getEnemyPixmap / getUserPixmap 的路径与缓存键保持一致
+    const EnemyState enemyStates[] = {ENEMY_IDLE, ENEMY_WALK, ENEMY_JUMP, ENEMY_DEAD};
+    for (int type = 0; type < GameConfig::ENEMY_TYPE_NUMBER; ++type)
     {
-        if (effect && !effect->isPlaying())
+        for (EnemyState state : enemyStates)
         {
-            return effect;
+            QString stateName = enemyStateName(state);
+            ImageJob job;
+            job.paths << QString(":/image/enemy/image/enemy_%1_%2.png").arg(type).arg(stateName)
+                      << QString(":/image/enemy/image/enemy_%1.png").arg(stateName);
+            job.targets << ImageTarget{QString("enemy_%1_%2").arg(type).arg(stateName), enemySize, Qt::KeepAspectRatio};
+            jobs << job;
         }
     }
+    const char *userStates[] = {"walk", "dead"};
+    for (const char *stateName : userStates)
+    {
+        ImageJob job;
+        job.paths << QString(":/image/user/image/user_%1.png").arg(stateName);
+        job.targets << ImageTarget{QString("user_%1").arg(stateName), enemySize, Qt::KeepAspectRatio};
+        jobs << job;
+    }
 
-    QSoundEffect *effect = new QSoundEffect(this);
+    // 塔、底座与子弹的视觉等级随类型递增（箭塔 1、炮塔 2、魔法塔 3），与 Tower / Bullet 构造时一致
+    const char *towerNames[] = {"arrow_tower", "cannon_tower", "magic_tower"};
+    const char *bulletNames[] = {"arrow", "cannon", "magic"};
+    for (int type = TOWER_ARROW; type <= TOWER_MAGIC; ++type)
+    {
+        const int level = type + 1;
+
+        ImageJob tower;
+        if (level > 1)
+            tower.paths << QString(":/image/tower/image/%1_lvl%2.png").arg(towerNames[type]).arg(level);
+        tower.paths << QString(":/image/tower/image/%1.png").arg(towerNames[type]);
+        tower.targets << ImageTarget{QString("tower_%1_lvl%2").arg(type).arg(level), gridSize, Qt::KeepAspectRatio};
+        jobs << tower;
+
+        ImageJob base;
+        base.paths << QString(":/image/tower/image/%1_base.png").arg(towerNames[type]);
+        base.targets << ImageTarget{QString("tower_base_%1_lvl%2").arg(type).arg(level), gridSize, Qt::KeepAspectRatio};
+        jobs << base;
+
+        ImageJob bullet;
+        if (level > 1)
+            bullet.paths << QString(":/image/bullet/image/%1_lvl%2.png").arg(bulletNames[type]).arg(level);
+        bullet.paths << QString(":/image/bullet/image/%1.png").arg(bulletNames[type]);
+        bullet.targets << ImageTarget{QString("bullet_%1_lvl%2").arg(type).arg(level), gridSize, Qt::KeepAspectRatio};
+        jobs << bullet;
+    }
 
-    QString fileName;
-    if (soundId == "coin")
-        fileName = "coin.wav";
-    else if (soundId == "hurt")
-        fileName = "hurt.wav";
-    else if (soundId.startsWith("shoot_"))
-        fileName = soundId + ".wav";
-    else
-        fileName = soundId + ".wav";
+    // 地图只解码一次，同时产出整屏背景与关卡预览
+    const GameConfig::MapId maps[] = {GameConfig::MAP1, GameConfig::MAP2};
+    for (GameConfig::MapId mapId : maps)
+    {
+        ImageJob job;
+        job.paths << mapResourcePath(mapId);
+        job.targets << ImageTarget{mapKey(mapId),
+                                   QSize(GameConfig::WINDOW_WIDTH, GameConfig::WINDOW_HEIGHT),
+                                   Qt::IgnoreAspectRatio}
+                    << ImageTarget{mapPreviewKey(mapId),
+                                   QSize(MAP_PREVIEW_WIDTH, MAP_PREVIEW_HEIGHT),
+                                   Qt::KeepAspectRatio};
+        jobs << job;
+    }
+    return jobs;
+}
 
-    QString resourcePath = QStringLiteral("qrc:/sound/sound/") + fileName;
-    effect->setSource(QUrl(resourcePath));
+QList<QImage> ResourceManager::decodeImageJob(const ImageJob &job)
+{
+    QImage source;
+    for (const QString &path : job.paths)
+    {
+        if (source.load(path))
+            break;
+    }
 
-    pool.append(effect);
-    return effect;
+    // 解码失败时返回空图，GUI 线程不写缓存，按需加载会回落到占位图
+    QList<QImage> results;
+    for (const ImageTarget &target : job.targets)
+    {
+        if (source.isNull())
+            results << QImage();
+        else
+            results << source.scaled(target.size, target.mode, Qt::SmoothTransformation);
+    }
+    return results;
 }
 
-void ResourceManager::playSound(const QString &soundId, qreal volume, bool loop)
+void ResourceManager::preloadAssetsAsync()
 {
-    QSoundEffect *effect = acquireSoundEffect(soundId);
-    if (!effect)
+    if (preloadStarted)
         return;
+    preloadStarted = true;
 
-    qreal v = volume;
-    if (v < 0.0)
-        v = 0.0;
-    if (v > 1.0)
-        v = 1.0;
+    QList<ImageJob> jobs = buildImageJobs();
+    assetsTotal = 0;
+    for (const ImageJob &job : jobs)
+        assetsTotal += job.targets.size();
 
-    effect->setVolume(v);
-    effect->setLoopCount(loop ? QSoundEffect::Infinite : 1);
-    effect->stop();
-    effect->play();
+    // 音效已经同步加载过时（例如先调用过 playSound）不再重复解码
+    if (!soundsLoaded)
+    {
+        soundsPending = static_cast<int>(sizeof(SOUND_SPECS) / sizeof(SOUND_SPECS[0]));
+        assetsTotal += soundsPending;
+    }
+    emit loadProgress(0, assetsTotal);
+
+    // 工作线程只产出 QImage / PCM 数据，QPixmap 转换与混音器登记都回到 GUI 线程
+    for (const ImageJob &job : jobs)
+    {
+        QtConcurrent::run([this, job]() {
+            QList<QImage> images = decodeImageJob(job);
+            for (int i = 0; i < job.targets.size(); ++i)
+            {
+                QString key = job.targets.at(i).key;
+                QImage image = images.at(i);
+                QMetaObject::invokeMethod(this, [this, key, image]() {
+                    onImageDecoded(key, image);
+                }, Qt::QueuedConnection);
+            }
+        });
+    }
+
+    if (soundsPending == 0)
+        return;
+    for (const SoundSpec &spec : SOUND_SPECS)
+    {
+        QString soundId = QString::fromLatin1(spec.soundId);
+        int priority = spec.priority;
+        int minIntervalMs = spec.minIntervalMs;
+        QtConcurrent::run([this, soundId, priority, minIntervalMs]() {
+            QVector<qint16> samples;
+            AudioMixer::decodeWavFile(soundResourcePath(soundId), &samples);
+            QMetaObject::invokeMethod(this, [this, soundId, samples, priority, minIntervalMs]() {
+                onSoundDecoded(soundId, samples, priority, minIntervalMs);
+            }, Qt::QueuedConnection);
+        });
+    }
 }
 
-void ResourceManager::preloadDefaultSounds()
+void ResourceManager::onImageDecoded(const QString &key, const QImage &image)
 {
-    acquireSoundEffect("coin");
-    acquireSoundEffect("hurt");
-    acquireSoundEffect("shoot_arrow");
-    acquireSoundEffect("shoot_cannon");
-    acquireSoundEffect("shoot_magic");
+    // 已经被按需加载写入的键保持不变，避免同一贴图前后两份
+    if (!image.isNull() && !pixmapCache.contains(key))
+        pixmapCache.insert(key, QPixmap::fromImage(image));
+    finishAsset(key);
+}
+
+void ResourceManager::onSoundDecoded(const QString &soundId, const QVector<qint16> &samples, int priority, int minIntervalMs)
+{
+    if (!samples.isEmpty())
+        audioMixer->addClip(soundId, samples, priority, minIntervalMs);
+
+    soundsPending--;
+    if (soundsPending == 0)
+        soundsLoaded = true;
+    finishAsset(soundId);
+}
+
+void ResourceManager::finishAsset(const QString &key)
+{
+    assetsLoaded++;
+    emit assetLoaded(key);
+    emit loadProgress(assetsLoaded, assetsTotal);
+    if (assetsLoaded == assetsTotal)
+    {
+        LOG_INFO(CATEGORY_GAME, "Preloaded %1 assets", assetsTotal);
+        emit assetsReady();
+    }
 }
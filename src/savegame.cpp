@@ -0,0 +1,74 @@
+#include "include/savegame.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtConcurrent>
+#include <QDebug>
+#include <atomic>
+
+namespace
+{
+    // 提交序号与已落盘序号：后台任务乱序执行时丢弃过期请求
+    std::atomic<quint64> submittedSequence(0);
+    quint64 completedSequence = 0;
+    QMutex fileMutex;
+}
+
+QString SaveGame::autosavePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/autosave.tes";
+}
+
+bool SaveGame::hasAutosave()
+{
+    return QFileInfo::exists(autosavePath());
+}
+
+QByteArray SaveGame::readAutosave()
+{
+    QMutexLocker locker(&fileMutex);
+    QFile file(autosavePath());
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    return file.readAll();
+}
+
+void SaveGame::writeAutosaveAsync(const QByteArray &data)
+{
+    submit(data, false);
+}
+
+void SaveGame::removeAutosaveAsync()
+{
+    submit(QByteArray(), true);
+}
+
+void SaveGame::submit(const QByteArray &data, bool remove)
+{
+    quint64 sequence = submittedSequence.fetch_add(1) + 1;
+    QString path = autosavePath();
+
+    QtConcurrent::run([data, remove, sequence, path]() {
+        QMutexLocker locker(&fileMutex);
+        if (sequence < completedSequence)
+            return;
+        completedSequence = sequence;
+
+        if (remove)
+        {
+            QFile::remove(path);
+            return;
+        }
+
+        // QSaveFile 先写临时文件再改名，写到一半崩溃也不会留下损坏的存档
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit())
+            qWarning() << "[SaveGame] Failed to write" << path;
+    });
+}
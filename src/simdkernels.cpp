@@ -0,0 +1,421 @@
+#include "include/simdkernels.h"
+
+#include <cmath>
+
+// 只在 x86 上提供向量实现；GCC/Clang 用函数级 target 属性，整个工程无需额外编译选项
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TE_SIMD_X86 1
+#define TE_TARGET_SSE2 __attribute__((target("sse2")))
+#define TE_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define TE_SIMD_X86 1
+#define TE_TARGET_SSE2
+#define TE_TARGET_AVX2
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+using SimdKernels::Backend;
+using SimdKernels::HomingBatch;
+
+namespace
+{
+    typedef void (*AdvanceProgressFn)(float *, const float *, const float *, const float *, int);
+    typedef void (*StepHomingFn)(const HomingBatch &, float, float, float);
+    typedef int (*CollectInRangeFn)(const float *, const float *, int, float, float, float, qint32 *);
+
+    void advanceProgressScalar(float *progress, const float *speed, const float *steps, const float *length, int count)
+    {
+        for (int i = 0; i < count; ++i)
+            progress[i] = qMin(progress[i] + speed[i] * steps[i], length[i]);
+    }
+
+    // 单颗子弹的标量实现，也用于向量实现处理尾部
+    void stepHomingLane(const HomingBatch &batch, int i, float hitRadius, float cosMaxTurn, float sinMaxTurn)
+    {
+        float dirX = batch.dirX[i];
+        float dirY = batch.dirY[i];
+        bool tracking = batch.tracking[i] != 0;
+        bool hit = false;
+
+        if (tracking)
+        {
+            float toX = batch.targetX[i] - batch.x[i];
+            float toY = batch.targetY[i] - batch.y[i];
+            float distance = std::sqrt(toX * toX + toY * toY);
+            if (distance <= hitRadius)
+            {
+                hit = true;
+            }
+            else if (distance > 0.0f)
+            {
+                float desiredX = toX / distance;
+                float desiredY = toY / distance;
+                float dot = dirX * desiredX + dirY * desiredY;
+                if (dot < 0.0f)
+                {
+                    // 目标跑到身后，放弃追踪直线飞行
+                    tracking = false;
+                }
+                else if (dot >= cosMaxTurn)
+                {
+                    // 偏角不超过单步最大转角，直接对准
+                    dirX = desiredX;
+                    dirY = desiredY;
+                }
+                else
+                {
+                    // 按叉积符号朝目标一侧转最大角，用预先算好的正余弦代替 acos/cos/sin
+                    float cross = dirX * desiredY - dirY * desiredX;
+                    float s = cross >= 0.0f ? sinMaxTurn : -sinMaxTurn;
+                    float rotatedX = dirX * cosMaxTurn - dirY * s;
+                    float rotatedY = dirX * s + dirY * cosMaxTurn;
+                    float rotatedLength = std::sqrt(rotatedX * rotatedX + rotatedY * rotatedY);
+                    dirX = rotatedX / rotatedLength;
+                    dirY = rotatedY / rotatedLength;
+                }
+            }
+        }
+
+        batch.hit[i] = hit ? 1 : 0;
+        batch.tracking[i] = tracking ? 1 : 0;
+        if (!hit)
+        {
+            batch.dirX[i] = dirX;
+            batch.dirY[i] = dirY;
+            batch.x[i] += dirX * batch.speed[i];
+            batch.y[i] += dirY * batch.speed[i];
+        }
+    }
+
+    void stepHomingScalar(const HomingBatch &batch, float hitRadius, float cosMaxTurn, float sinMaxTurn)
+    {
+        for (int i = 0; i < batch.count; ++i)
+            stepHomingLane(batch, i, hitRadius, cosMaxTurn, sinMaxTurn);
+    }
+
+    // first 为数组起点下标，供向量实现处理尾部时接着编号
+    int collectInRangeScalar(const float *x, const float *y, int first, int count,
+                             float centerX, float centerY, float radiusSq, qint32 *out)
+    {
+        int found = 0;
+        for (int i = first; i < count; ++i)
+        {
+            float dx = x[i] - centerX;
+            float dy = y[i] - centerY;
+            if (dx * dx + dy * dy <= radiusSq)
+                out[found++] = i;
+        }
+        return found;
+    }
+
+    int collectInRangeScalarAll(const float *x, const float *y, int count, float centerX, float centerY, float radiusSq, qint32 *out)
+    {
+        return collectInRangeScalar(x, y, 0, count, centerX, centerY, radiusSq, out);
+    }
+
+#ifdef TE_SIMD_X86
+    TE_TARGET_SSE2 void advanceProgressSse2(float *progress, const float *speed, const float *steps, const float *length, int count)
+    {
+        int i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 moved = _mm_add_ps(_mm_loadu_ps(progress + i),
+                                      _mm_mul_ps(_mm_loadu_ps(speed + i), _mm_loadu_ps(steps + i)));
+            _mm_storeu_ps(progress + i, _mm_min_ps(moved, _mm_loadu_ps(length + i)));
+        }
+        advanceProgressScalar(progress + i, speed + i, steps + i, length + i, count - i);
+    }
+
+    // 与 stepHomingLane 逐条对应，分支改为掩码选择
+    TE_TARGET_SSE2 void stepHomingSse2(const HomingBatch &batch, float hitRadius, float cosMaxTurn, float sinMaxTurn)
+    {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 allOnes = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        const __m128 signBit = _mm_set1_ps(-0.0f);
+        const __m128 radius = _mm_set1_ps(hitRadius);
+        const __m128 cosTurn = _mm_set1_ps(cosMaxTurn);
+        const __m128 sinTurn = _mm_set1_ps(sinMaxTurn);
+        const __m128i one = _mm_set1_epi32(1);
+
+        int i = 0;
+        for (; i + 4 <= batch.count; i += 4)
+        {
+            __m128 x = _mm_loadu_ps(batch.x + i);
+            __m128 y = _mm_loadu_ps(batch.y + i);
+            __m128 dirX = _mm_loadu_ps(batch.dirX + i);
+            __m128 dirY = _mm_loadu_ps(batch.dirY + i);
+            __m128i trackingBits = _mm_loadu_si128(reinterpret_cast<const __m128i *>(batch.tracking + i));
+            __m128 tracking = _mm_andnot_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(trackingBits, _mm_setzero_si128())), allOnes);
+
+            __m128 toX = _mm_sub_ps(_mm_loadu_ps(batch.targetX + i), x);
+            __m128 toY = _mm_sub_ps(_mm_loadu_ps(batch.targetY + i), y);
+            __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(toX, toX), _mm_mul_ps(toY, toY)));
+            __m128 hit = _mm_and_ps(tracking, _mm_cmple_ps(distance, radius));
+            __m128 live = _mm_and_ps(_mm_andnot_ps(hit, tracking), _mm_cmpgt_ps(distance, zero));
+
+            __m128 desiredX = _mm_div_ps(toX, distance);
+            __m128 desiredY = _mm_div_ps(toY, distance);
+            __m128 dot = _mm_add_ps(_mm_mul_ps(dirX, desiredX), _mm_mul_ps(dirY, desiredY));
+            __m128 lost = _mm_and_ps(live, _mm_cmplt_ps(dot, zero));
+            __m128 steer = _mm_andnot_ps(lost, live);
+            __m128 snap = _mm_cmpge_ps(dot, cosTurn);
+
+            __m128 cross = _mm_sub_ps(_mm_mul_ps(dirX, desiredY), _mm_mul_ps(dirY, desiredX));
+            __m128 s = _mm_xor_ps(sinTurn, _mm_andnot_ps(_mm_cmpge_ps(cross, zero), signBit));
+            __m128 rotatedX = _mm_sub_ps(_mm_mul_ps(dirX, cosTurn), _mm_mul_ps(dirY, s));
+            __m128 rotatedY = _mm_add_ps(_mm_mul_ps(dirX, s), _mm_mul_ps(dirY, cosTurn));
+            __m128 rotatedLength = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(rotatedX, rotatedX), _mm_mul_ps(rotatedY, rotatedY)));
+            rotatedX = _mm_div_ps(rotatedX, rotatedLength);
+            rotatedY = _mm_div_ps(rotatedY, rotatedLength);
+
+            __m128 turnedX = _mm_or_ps(_mm_and_ps(snap, desiredX), _mm_andnot_ps(snap, rotatedX));
+            __m128 turnedY = _mm_or_ps(_mm_and_ps(snap, desiredY), _mm_andnot_ps(snap, rotatedY));
+            dirX = _mm_or_ps(_mm_and_ps(steer, turnedX), _mm_andnot_ps(steer, dirX));
+            dirY = _mm_or_ps(_mm_and_ps(steer, turnedY), _mm_andnot_ps(steer, dirY));
+
+            __m128 speed = _mm_loadu_ps(batch.speed + i);
+            _mm_storeu_ps(batch.dirX + i, dirX);
+            _mm_storeu_ps(batch.dirY + i, dirY);
+            _mm_storeu_ps(batch.x + i, _mm_add_ps(x, _mm_andnot_ps(hit, _mm_mul_ps(dirX, speed))));
+            _mm_storeu_ps(batch.y + i, _mm_add_ps(y, _mm_andnot_ps(hit, _mm_mul_ps(dirY, speed))));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(batch.hit + i), _mm_and_si128(_mm_castps_si128(hit), one));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(batch.tracking + i),
+                             _mm_and_si128(_mm_castps_si128(_mm_andnot_ps(lost, tracking)), one));
+        }
+        for (; i < batch.count; ++i)
+            stepHomingLane(batch, i, hitRadius, cosMaxTurn, sinMaxTurn);
+    }
+
+    TE_TARGET_SSE2 int collectInRangeSse2(const float *x, const float *y, int count, float centerX, float centerY, float radiusSq, qint32 *out)
+    {
+        const __m128 cx = _mm_set1_ps(centerX);
+        const __m128 cy = _mm_set1_ps(centerY);
+        const __m128 limit = _mm_set1_ps(radiusSq);
+        int found = 0;
+        int i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), cx);
+            __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), cy);
+            int mask = _mm_movemask_ps(_mm_cmple_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), limit));
+            // 多数点不在射程内，整组落空时直接跳过
+            if (!mask)
+                continue;
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                if (mask & (1 << lane))
+                    out[found++] = i + lane;
+            }
+        }
+        return found + collectInRangeScalar(x, y, i, count, centerX, centerY, radiusSq, out + found);
+    }
+
+    TE_TARGET_AVX2 void advanceProgressAvx2(float *progress, const float *speed, const float *steps, const float *length, int count)
+    {
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 moved = _mm256_add_ps(_mm256_loadu_ps(progress + i),
+                                         _mm256_mul_ps(_mm256_loadu_ps(speed + i), _mm256_loadu_ps(steps + i)));
+            _mm256_storeu_ps(progress + i, _mm256_min_ps(moved, _mm256_loadu_ps(length + i)));
+        }
+        advanceProgressScalar(progress + i, speed + i, steps + i, length + i, count - i);
+    }
+
+    TE_TARGET_AVX2 void stepHomingAvx2(const HomingBatch &batch, float hitRadius, float cosMaxTurn, float sinMaxTurn)
+    {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 signBit = _mm256_set1_ps(-0.0f);
+        const __m256 radius = _mm256_set1_ps(hitRadius);
+        const __m256 cosTurn = _mm256_set1_ps(cosMaxTurn);
+        const __m256 sinTurn = _mm256_set1_ps(sinMaxTurn);
+        const __m256i allOnes = _mm256_set1_epi32(-1);
+        const __m256i one = _mm256_set1_epi32(1);
+
+        int i = 0;
+        for (; i + 8 <= batch.count; i += 8)
+        {
+            __m256 x = _mm256_loadu_ps(batch.x + i);
+            __m256 y = _mm256_loadu_ps(batch.y + i);
+            __m256 dirX = _mm256_loadu_ps(batch.dirX + i);
+            __m256 dirY = _mm256_loadu_ps(batch.dirY + i);
+            __m256i trackingBits = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(batch.tracking + i));
+            __m256 tracking = _mm256_castsi256_ps(_mm256_xor_si256(_mm256_cmpeq_epi32(trackingBits, _mm256_setzero_si256()), allOnes));
+
+            __m256 toX = _mm256_sub_ps(_mm256_loadu_ps(batch.targetX + i), x);
+            __m256 toY = _mm256_sub_ps(_mm256_loadu_ps(batch.targetY + i), y);
+            __m256 distance = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(toX, toX), _mm256_mul_ps(toY, toY)));
+            __m256 hit = _mm256_and_ps(tracking, _mm256_cmp_ps(distance, radius, _CMP_LE_OQ));
+            __m256 live = _mm256_and_ps(_mm256_andnot_ps(hit, tracking), _mm256_cmp_ps(distance, zero, _CMP_GT_OQ));
+
+            __m256 desiredX = _mm256_div_ps(toX, distance);
+            __m256 desiredY = _mm256_div_ps(toY, distance);
+            __m256 dot = _mm256_add_ps(_mm256_mul_ps(dirX, desiredX), _mm256_mul_ps(dirY, desiredY));
+            __m256 lost = _mm256_and_ps(live, _mm256_cmp_ps(dot, zero, _CMP_LT_OQ));
+            __m256 steer = _mm256_andnot_ps(lost, live);
+            __m256 snap = _mm256_cmp_ps(dot, cosTurn, _CMP_GE_OQ);
+
+            __m256 cross = _mm256_sub_ps(_mm256_mul_ps(dirX, desiredY), _mm256_mul_ps(dirY, desiredX));
+            __m256 s = _mm256_xor_ps(sinTurn, _mm256_andnot_ps(_mm256_cmp_ps(cross, zero, _CMP_GE_OQ), signBit));
+            __m256 rotatedX = _mm256_sub_ps(_mm256_mul_ps(dirX, cosTurn), _mm256_mul_ps(dirY, s));
+            __m256 rotatedY = _mm256_add_ps(_mm256_mul_ps(dirX, s), _mm256_mul_ps(dirY, cosTurn));
+            __m256 rotatedLength = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(rotatedX, rotatedX), _mm256_mul_ps(rotatedY, rotatedY)));
+            rotatedX = _mm256_div_ps(rotatedX, rotatedLength);
+            rotatedY = _mm256_div_ps(rotatedY, rotatedLength);
+
+            dirX = _mm256_blendv_ps(dirX, _mm256_blendv_ps(rotatedX, desiredX, snap), steer);
+            dirY = _mm256_blendv_ps(dirY, _mm256_blendv_ps(rotatedY, desiredY, snap), steer);
+
+            __m256 speed = _mm256_loadu_ps(batch.speed + i);
+            _mm256_storeu_ps(batch.dirX + i, dirX);
+            _mm256_storeu_ps(batch.dirY + i, dirY);
+            _mm256_storeu_ps(batch.x + i, _mm256_add_ps(x, _mm256_andnot_ps(hit, _mm256_mul_ps(dirX, speed))));
+            _mm256_storeu_ps(batch.y + i, _mm256_add_ps(y, _mm256_andnot_ps(hit, _mm256_mul_ps(dirY, speed))));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(batch.hit + i), _mm256_and_si256(_mm256_castps_si256(hit), one));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(batch.tracking + i),
+                                _mm256_and_si256(_mm256_castps_si256(_mm256_andnot_ps(lost, tracking)), one));
+        }
+        for (; i < batch.count; ++i)
+            stepHomingLane(batch, i, hitRadius, cosMaxTurn, sinMaxTurn);
+    }
+
+    TE_TARGET_AVX2 int collectInRangeAvx2(const float *x, const float *y, int count, float centerX, float centerY, float radiusSq, qint32 *out)
+    {
+        const __m256 cx = _mm256_set1_ps(centerX);
+        const __m256 cy = _mm256_set1_ps(centerY);
+        const __m256 limit = _mm256_set1_ps(radiusSq);
+        int found = 0;
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), cx);
+            __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i), cy);
+            __m256 distanceSq = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            int mask = _mm256_movemask_ps(_mm256_cmp_ps(distanceSq, limit, _CMP_LE_OQ));
+            if (!mask)
+                continue;
+            for (int lane = 0; lane < 8; ++lane)
+            {
+                if (mask & (1 << lane))
+                    out[found++] = i + lane;
+            }
+        }
+        return found + collectInRangeScalar(x, y, i, count, centerX, centerY, radiusSq, out + found);
+    }
+#endif
+
+    Backend detectBackend()
+    {
+#if defined(TE_SIMD_X86) && defined(__GNUC__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return SimdKernels::BACKEND_AVX2;
+        if (__builtin_cpu_supports("sse2"))
+            return SimdKernels::BACKEND_SSE2;
+#elif defined(TE_SIMD_X86)
+        int info[4];
+        __cpuid(info, 0);
+        const int maxLeaf = info[0];
+        __cpuid(info, 1);
+        const bool sse2 = (info[3] & (1 << 26)) != 0;
+        // AVX 寄存器需要操作系统保存，检查 OSXSAVE 与 XCR0
+        const bool osAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+        if (osAvx && maxLeaf >= 7)
+        {
+            __cpuidex(info, 7, 0);
+            if (info[1] & (1 << 5))
+                return SimdKernels::BACKEND_AVX2;
+        }
+        if (sse2)
+            return SimdKernels::BACKEND_SSE2;
+#endif
+        return SimdKernels::BACKEND_SCALAR;
+    }
+
+    // 当前生效的一组内核
+    struct KernelTable
+    {
+        Backend backend;
+        AdvanceProgressFn advanceProgress;
+        StepHomingFn stepHoming;
+        CollectInRangeFn collectInRange;
+    };
+
+    KernelTable tableFor(Backend backend)
+    {
+        KernelTable table = { SimdKernels::BACKEND_SCALAR, advanceProgressScalar, stepHomingScalar, collectInRangeScalarAll };
+#ifdef TE_SIMD_X86
+        if (backend == SimdKernels::BACKEND_AVX2)
+        {
+            table.backend = backend;
+            table.advanceProgress = advanceProgressAvx2;
+            table.stepHoming = stepHomingAvx2;
+            table.collectInRange = collectInRangeAvx2;
+        }
+        else if (backend == SimdKernels::BACKEND_SSE2)
+        {
+            table.backend = backend;
+            table.advanceProgress = advanceProgressSse2;
+            table.stepHoming = stepHomingSse2;
+            table.collectInRange = collectInRangeSse2;
+        }
+#else
+        Q_UNUSED(backend);
+#endif
+        return table;
+    }
+
+    KernelTable &activeTable()
+    {
+        static KernelTable table = tableFor(SimdKernels::bestSupportedBackend());
+        return table;
+    }
+}
+
+Backend SimdKernels::bestSupportedBackend()
+{
+    static const Backend best = detectBackend();
+    return best;
+}
+
+Backend SimdKernels::activeBackend()
+{
+    return activeTable().backend;
+}
+
+Backend SimdKernels::setBackend(Backend backend)
+{
+    activeTable() = tableFor(qMin(backend, bestSupportedBackend()));
+    return activeTable().backend;
+}
+
+const char *SimdKernels::backendName(Backend backend)
+{
+    switch (backend)
+    {
+    case BACKEND_AVX2:
+        return "avx2";
+    case BACKEND_SSE2:
+        return "sse2";
+    case BACKEND_SCALAR:
+        break;
+    }
+    return "scalar";
+}
+
+void SimdKernels::advanceProgress(float *progress, const float *speed, const float *steps, const float *length, int count)
+{
+    activeTable().advanceProgress(progress, speed, steps, length, count);
+}
+
+void SimdKernels::stepHoming(const HomingBatch &batch, float hitRadius, float cosMaxTurn, float sinMaxTurn)
+{
+    activeTable().stepHoming(batch, hitRadius, cosMaxTurn, sinMaxTurn);
+}
+
+int SimdKernels::collectInRange(const float *x, const float *y, int count, float centerX, float centerY, float radiusSq, qint32 *out)
+{
+    return activeTable().collectInRange(x, y, count, centerX, centerY, radiusSq, out);
+}
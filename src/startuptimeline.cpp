@@ -0,0 +1,142 @@
+#include "include/startuptimeline.h"
+#include "include/config.h"
+
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QFile>
+#include <QStringList>
+#include <QWidget>
+#include <QDebug>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // 静态初始化阶段启动计时，早于 main 与任何 Qt 对象
+    QElapsedTimer &staticClock()
+    {
+        static QElapsedTimer clock;
+        if (!clock.isValid())
+            clock.start();
+        return clock;
+    }
+
+    const bool clockStarted = (staticClock(), true);
+
+    // 静态初始化之前进程已存活的毫秒数（动态链接、加载器耗时），仅 Linux 可取得
+    qint64 preStaticInitMs()
+    {
+#ifdef Q_OS_LINUX
+        QFile statFile(QStringLiteral("/proc/self/stat"));
+        QFile uptimeFile(QStringLiteral("/proc/uptime"));
+        if (!statFile.open(QIODevice::ReadOnly) || !uptimeFile.open(QIODevice::ReadOnly))
+            return 0;
+
+        // comm 字段可能含空格，从最后一个 ')' 之后开始数：starttime 是第 22 个字段
+        QByteArray stat = statFile.readAll();
+        int commEnd = stat.lastIndexOf(')');
+        QList<QByteArray> fields = stat.mid(commEnd + 2).split(' ');
+        const int startTimeIndex = 22 - 3;
+        if (fields.size() <= startTimeIndex)
+            return 0;
+
+        long ticksPerSecond = sysconf(_SC_CLK_TCK);
+        double startSeconds = fields.at(startTimeIndex).toDouble() / ticksPerSecond;
+        double uptimeSeconds = uptimeFile.readAll().split(' ').value(0).toDouble();
+        qint64 aliveMs = static_cast<qint64>((uptimeSeconds - startSeconds) * 1000.0) - staticClock().elapsed();
+        return qMax<qint64>(0, aliveMs);
+#else
+        return 0;
+#endif
+    }
+}
+
+StartupTimeline::StartupTimeline()
+    : QObject(nullptr),
+      paintMarkName(nullptr),
+      done(false)
+{
+    Q_UNUSED(clockStarted);
+    Milestone start = {"process_start", 0};
+    Milestone staticInit = {"static_init", preStaticInitMs()};
+    milestones.append(start);
+    milestones.append(staticInit);
+}
+
+StartupTimeline &StartupTimeline::instance()
+{
+    static StartupTimeline instance;
+    return instance;
+}
+
+qint64 StartupTimeline::elapsedMs() const
+{
+    return milestones.at(1).ms + staticClock().elapsed();
+}
+
+void StartupTimeline::mark(const char *name)
+{
+    if (done)
+        return;
+    Milestone milestone = {name, elapsedMs()};
+    milestones.append(milestone);
+}
+
+void StartupTimeline::markOnFirstPaint(QWidget *widget, const char *name)
+{
+    if (done || !widget)
+        return;
+    paintWidget = widget;
+    paintMarkName = name;
+    widget->installEventFilter(this);
+}
+
+bool StartupTimeline::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == paintWidget && event->type() == QEvent::Paint)
+    {
+        paintWidget->removeEventFilter(this);
+        // 子控件与窗口缓冲在本轮事件处理中才画完并刷新，排队到其后再记录
+        QMetaObject::invokeMethod(this, [this]() { finishFirstPaint(); }, Qt::QueuedConnection);
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void StartupTimeline::finishFirstPaint()
+{
+    if (done)
+        return;
+    mark(paintMarkName ? paintMarkName : "first_paint");
+    done = true;
+
+    qDebug().noquote() << report();
+    if (!withinBudget())
+    {
+        qWarning() << "[Startup] First paint took" << milestones.last().ms
+                   << "ms, budget is" << GameConfig::STARTUP_FIRST_PAINT_BUDGET_MS << "ms";
+    }
+    emit finished();
+}
+
+bool StartupTimeline::withinBudget() const
+{
+    return done && milestones.last().ms <= GameConfig::STARTUP_FIRST_PAINT_BUDGET_MS;
+}
+
+QString StartupTimeline::report() const
+{
+    QStringList lines;
+    lines << QStringLiteral("[Startup] timeline (ms since process start):");
+    qint64 previous = 0;
+    for (const Milestone &milestone : milestones)
+    {
+        lines << QString("  %1 %2  (+%3)")
+                     .arg(QString::fromLatin1(milestone.name), -20)
+                     .arg(milestone.ms, 6)
+                     .arg(milestone.ms - previous);
+        previous = milestone.ms;
+    }
+    return lines.join('\n');
+}
@@ -0,0 +1,260 @@
+#include "include/targetingindex.h"
+#include "include/simdkernels.h"
+#include "include/config.h"
+#include "include/logger.h"
+
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <atomic>
+#include <limits>
+
+namespace
+{
+    const int CELL_SIZE = GameConfig::GRID_SIZE * 2;
+    const int CELL_COLUMNS = (GameConfig::WINDOW_WIDTH + CELL_SIZE - 1) / CELL_SIZE;
+    const int CELL_ROWS = (GameConfig::WINDOW_HEIGHT + CELL_SIZE - 1) / CELL_SIZE;
+    const int NEVER = std::numeric_limits<int>::max();
+
+    // 阈值按塔数分三档：不足 8、不足 32、其余；校准时每档用下列塔数代表
+    const int TOWER_BUCKETS = 3;
+    const int CALIBRATION_TOWERS[TOWER_BUCKETS] = {4, 16, 64};
+    // 校准完成前的默认值，取自 x86-64 AVX2 上的实测：暴力扫描一直领先到数千敌人，
+    // 塔多时网格才追上；均匀分布下四叉树重建开销始终追不回来
+    const int DEFAULT_GRID_FROM[TOWER_BUCKETS] = {NEVER, 4096, 2048};
+
+    // 敌人数达到 gridFrom 改用网格，达到 treeFrom 改用四叉树
+    struct Thresholds
+    {
+        std::atomic<int> gridFrom[TOWER_BUCKETS];
+        std::atomic<int> treeFrom[TOWER_BUCKETS];
+
+        Thresholds()
+        {
+            for (int i = 0; i < TOWER_BUCKETS; ++i)
+            {
+                gridFrom[i].store(DEFAULT_GRID_FROM[i]);
+                treeFrom[i].store(NEVER);
+            }
+        }
+    };
+
+    Thresholds &thresholds()
+    {
+        static Thresholds instance;
+        return instance;
+    }
+
+    int towerBucket(int towerCount)
+    {
+        if (towerCount < 8)
+            return 0;
+        return towerCount < 32 ? 1 : 2;
+    }
+
+    // 地图外的敌人归入边缘格，查询时照样会被测到
+    int cellColumn(float x)
+    {
+        return qBound(0, static_cast<int>(x / CELL_SIZE), CELL_COLUMNS - 1);
+    }
+
+    int cellRow(float y)
+    {
+        return qBound(0, static_cast<int>(y / CELL_SIZE), CELL_ROWS - 1);
+    }
+}
+
+TargetingIndex::TargetingIndex()
+    : backend(BACKEND_BRUTE_FORCE),
+      forcedBackend(-1)
+{
+}
+
+TargetingIndex::Backend TargetingIndex::chooseBackend(int enemyCount, int towerCount)
+{
+    const Thresholds &limits = thresholds();
+    const int bucket = towerBucket(towerCount);
+    if (enemyCount < limits.gridFrom[bucket].load(std::memory_order_relaxed))
+        return BACKEND_BRUTE_FORCE;
+    if (enemyCount < limits.treeFrom[bucket].load(std::memory_order_relaxed))
+        return BACKEND_GRID;
+    return BACKEND_QUADTREE;
+}
+
+const char *TargetingIndex::backendName(Backend backend)
+{
+    switch (backend)
+    {
+    case BACKEND_GRID:
+        return "grid";
+    case BACKEND_QUADTREE:
+        return "quadtree";
+    case BACKEND_BRUTE_FORCE:
+        break;
+    }
+    return "brute-force";
+}
+
+void TargetingIndex::rebuild(const QVector<float> &x, const QVector<float> &y, int towerCount)
+{
+    xs = x;
+    ys = y;
+    backend = forcedBackend >= 0 ? static_cast<Backend>(forcedBackend) : chooseBackend(xs.size(), towerCount);
+    if (backend == BACKEND_GRID)
+        buildGrid();
+    else if (backend == BACKEND_QUADTREE)
+    {
+        tree.clear();
+        tree.reserve(xs.size());
+        for (int i = 0; i < xs.size(); ++i)
+            tree.insert(i, QPointF(xs[i], ys[i]));
+        tree.build();
+    }
+}
+
+void TargetingIndex::queryCircle(float centerX, float centerY, float radius, QVector<int> *out) const
+{
+    out->resize(0);
+    switch (backend)
+    {
+    case BACKEND_BRUTE_FORCE:
+    {
+        // 向量内核按下标顺序写出，天然有序
+        out->resize(xs.size());
+        int found = SimdKernels::collectInRange(xs.constData(), ys.constData(), xs.size(),
+                                                centerX, centerY, radius * radius, out->data());
+        out->resize(found);
+        return;
+    }
+    case BACKEND_QUADTREE:
+        tree.queryCircle(QPointF(centerX, centerY), radius, out);
+        return;
+    case BACKEND_GRID:
+        break;
+    }
+
+    // 网格按格子顺序找到敌人，先记入位图再按下标顺序取出，省去排序；
+    // 同时进入射程的敌人按列表先后决定锁定顺序，各实现须给出同样的次序
+    hitMask.fill(0, (xs.size() + 31) / 32);
+    queryGrid(centerX, centerY, radius);
+    for (int word = 0; word < hitMask.size(); ++word)
+    {
+        const quint32 bits = hitMask[word];
+        if (!bits)
+            continue;
+        for (int bit = 0; bit < 32; ++bit)
+        {
+            if (bits & (1u << bit))
+                out->append(word * 32 + bit);
+        }
+    }
+}
+
+void TargetingIndex::buildGrid()
+{
+    const int count = xs.size();
+    const int cellCount = CELL_COLUMNS * CELL_ROWS;
+
+    // 计数排序：先数每格人数，前缀和得到起点，再按下标顺序放入
+    cellStart.fill(0, cellCount + 1);
+    for (int i = 0; i < count; ++i)
+        cellStart[cellRow(ys[i]) * CELL_COLUMNS + cellColumn(xs[i]) + 1]++;
+    for (int cell = 0; cell < cellCount; ++cell)
+        cellStart[cell + 1] += cellStart[cell];
+
+    cellItems.resize(count);
+    for (int i = 0; i < count; ++i)
+        cellItems[cellStart[cellRow(ys[i]) * CELL_COLUMNS + cellColumn(xs[i])]++] = i;
+    // 放入时起点被推到了下一格的起点，整体后移一位复原
+    for (int cell = cellCount; cell > 0; --cell)
+        cellStart[cell] = cellStart[cell - 1];
+    cellStart[0] = 0;
+}
+
+void TargetingIndex::queryGrid(float centerX, float centerY, float radius) const
+{
+    if (cellStart.isEmpty())
+        return;
+
+    const float radiusSq = radius * radius;
+    const int firstColumn = cellColumn(centerX - radius);
+    const int lastColumn = cellColumn(centerX + radius);
+    const int firstRow = cellRow(centerY - radius);
+    const int lastRow = cellRow(centerY + radius);
+    for (int row = firstRow; row <= lastRow; ++row)
+    {
+        for (int column = firstColumn; column <= lastColumn; ++column)
+        {
+            const int cell = row * CELL_COLUMNS + column;
+            for (int k = cellStart[cell]; k < cellStart[cell + 1]; ++k)
+            {
+                const int i = cellItems[k];
+                const float dx = xs[i] - centerX;
+                const float dy = ys[i] - centerY;
+                if (dx * dx + dy * dy <= radiusSq)
+                    hitMask[i >> 5] |= 1u << (i & 31);
+            }
+        }
+    }
+}
+
+void TargetingIndex::calibrate()
+{
+    // 固定种子的均匀场景，敌人数从 16 翻倍到 4096，记录各实现开始占优的敌人数
+    QRandomGenerator rng(47);
+    const float radius = GameConfig::TowerStats::ARROW_RANGE;
+    TargetingIndex index;
+    QVector<int> found;
+    QElapsedTimer timer;
+    Thresholds &limits = thresholds();
+
+    for (int bucket = 0; bucket < TOWER_BUCKETS; ++bucket)
+    {
+        const int towerCount = CALIBRATION_TOWERS[bucket];
+        QVector<float> towerX(towerCount);
+        QVector<float> towerY(towerCount);
+        for (int t = 0; t < towerCount; ++t)
+        {
+            towerX[t] = static_cast<float>(rng.bounded(double(GameConfig::WINDOW_WIDTH)));
+            towerY[t] = static_cast<float>(rng.bounded(double(GameConfig::WINDOW_HEIGHT)));
+        }
+
+        int gridFrom = NEVER;
+        int treeFrom = NEVER;
+        for (int enemyCount = 16; enemyCount <= 4096; enemyCount *= 2)
+        {
+            QVector<float> x(enemyCount);
+            QVector<float> y(enemyCount);
+            for (int i = 0; i < enemyCount; ++i)
+            {
+                x[i] = static_cast<float>(rng.bounded(double(GameConfig::WINDOW_WIDTH)));
+                y[i] = static_cast<float>(rng.bounded(double(GameConfig::WINDOW_HEIGHT)));
+            }
+
+            // 每种实现取三次里最快的一次：一次重建加上每座塔一次查询
+            qint64 cost[3];
+            for (int candidate = BACKEND_BRUTE_FORCE; candidate <= BACKEND_QUADTREE; ++candidate)
+            {
+                index.forceBackend(candidate);
+                cost[candidate] = std::numeric_limits<qint64>::max();
+                for (int repeat = 0; repeat < 3; ++repeat)
+                {
+                    timer.start();
+                    index.rebuild(x, y, towerCount);
+                    for (int t = 0; t < towerCount; ++t)
+                        index.queryCircle(towerX[t], towerY[t], radius, &found);
+                    cost[candidate] = qMin(cost[candidate], timer.nsecsElapsed());
+                }
+            }
+
+            if (gridFrom == NEVER && qMin(cost[BACKEND_GRID], cost[BACKEND_QUADTREE]) < cost[BACKEND_BRUTE_FORCE])
+                gridFrom = enemyCount;
+            if (gridFrom != NEVER && treeFrom == NEVER && cost[BACKEND_QUADTREE] < cost[BACKEND_GRID])
+                treeFrom = enemyCount;
+        }
+
+        limits.gridFrom[bucket].store(gridFrom, std::memory_order_relaxed);
+        limits.treeFrom[bucket].store(treeFrom, std::memory_order_relaxed);
+        LOG_INFO(CATEGORY_TOWER, "Targeting calibrated for %1 towers: grid from %2, quadtree from %3 enemies",
+                 towerCount, gridFrom, treeFrom);
+    }
+}
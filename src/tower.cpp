@@ -3,6 +3,9 @@
 #include "include/bullet.h"
 #include "include/resourcemanager.h"
 #include "include/config.h"
+#include "include/tracerecorder.h"
+#include "include/logger.h"
+#include "include/fastmath.h"
 
 #include <QPainter>
 #include <QBrush>
@@ -10,26 +13,25 @@
 #include <QGraphicsScene>
 #include <QGraphicsPixmapItem>
 #include <QDebug>
-#include <QDateTime>
-#include <QTimer>
+#include <QDataStream>
 #include <math.h>
 #include <cmath>
 #include <limits>
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
-
 Tower::Tower(TowerType type, QPointF position, QObject *parent)
     : GameEntity(TOWER, parent),
       towerType(type),
       currentTarget(nullptr),
+      simTimeMs(0),
+      attackAccumulatorMs(0),
+      attackPaused(false),
       gameScene(nullptr),
       baseItem(nullptr),
       currentRotation(0.0),
       targetRotation(0.0),
       rotationSpeed(GameConfig::TOWER_ROTATION_SPEED_DEG_PER_SEC),
       targetLocked(false),
+      targetLockedAtMs(-1),
       targetLostTime(0),
       resourceManager(nullptr)
 {
@@ -86,18 +88,12 @@ Tower::Tower(TowerType type, QPointF position, QObject *parent)
     baseItem->setPos(position.x(), position.y());
     baseItem->setZValue(-1); // 底座在防御塔下层
 
-    // 初始化攻击定时器
-    attackTimer = new QTimer(this);
-    connect(attackTimer, &QTimer::timeout, this, &Tower::onAttackTimer);
-    attackTimer->start(fireRate);
-
     // 初始化防御塔生命值
     setHealth(100);
 }
 
 Tower::~Tower()
 {
-    attackTimer->stop();
     // 清理底座图形项
     if (baseItem && baseItem->scene())
     {
@@ -117,6 +113,21 @@ void Tower::update()
     updateTowerRotation();
 }
 
+void Tower::advance(int dtMs)
+{
+    simTimeMs += dtMs;
+    if (attackPaused)
+        return;
+
+    // 原攻击计时器的节拍改由模拟时间累加驱动；步长大于攻击间隔时一步内补齐所有节拍
+    attackAccumulatorMs += dtMs;
+    while (attackAccumulatorMs >= fireRate)
+    {
+        attackAccumulatorMs -= fireRate;
+        onAttackTick();
+    }
+}
+
 void Tower::setTarget(QPointer<Enemy> target)
 {
     currentTarget = target;
@@ -126,12 +137,14 @@ void Tower::fire()
 {
     if (currentTarget && gameScene)
     {
+        TraceScope traceScope("fire", "sim");
+
         // 获取防御塔炮管顶端的位置（场景坐标）
         QRectF rect = boundingRect();
         QPointF localTip(rect.width() / 2.0, 0.0);
         QPointF bulletStartPos = mapToScene(localTip);
 
-        qDebug() << "Tower firing from tip" << bulletStartPos;
+        LOG_DEBUG(CATEGORY_TOWER, "Tower firing from tip (%1, %2)", bulletStartPos.x(), bulletStartPos.y());
 
         // 根据防御塔类型确定子弹类型
         Bullet::BulletType bulletType = Bullet::BULLET_ARROW;
@@ -150,8 +163,10 @@ void Tower::fire()
 
         // 计算子弹初速度方向（根据防御塔旋转角度）
         qreal angleDeg = rotation() - 90.0;
-        qreal angleRad = angleDeg * M_PI / 180.0;
-        QPointF initialDir(std::cos(angleRad), std::sin(angleRad));
+        float sinAngle = 0.0f;
+        float cosAngle = 1.0f;
+        FastMath::sincos(static_cast<float>(angleDeg) * FastMath::DEG_TO_RAD, &sinAngle, &cosAngle);
+        QPointF initialDir(cosAngle, sinAngle);
 
         // 创建子弹对象
         QPointer<Bullet> bullet = new Bullet(bulletType, bulletStartPos, initialDir, currentTarget, damage, nullptr);
@@ -163,8 +178,9 @@ void Tower::fire()
             }
             gameScene->addItem(bullet);
             targetLocked = true;
-            targetLockTimer.restart();
+            targetLockedAtMs = simTimeMs;
             emit fired();
+            emit bulletFired(bullet);
             QString soundId;
             switch (towerType)
             {
@@ -187,9 +203,96 @@ void Tower::fire()
     }
 }
 
+void Tower::saveState(QDataStream &out, const QHash<const Enemy *, int> &enemyIndex) const
+{
+    out << static_cast<qint8>(towerType)
+        << x() << y()
+        << static_cast<qint32>(damage)
+        << static_cast<qint32>(range)
+        << static_cast<qint32>(fireRate)
+        << static_cast<qint32>(cost)
+        << simTimeMs
+        << static_cast<qint32>(attackAccumulatorMs)
+        << rotation() << currentRotation << targetRotation
+        << targetLocked << targetLockedAtMs << targetLostTime
+        << static_cast<qint16>(enemyIndex.value(currentTarget.data(), -1));
+
+    // 进入射程时间决定选靶顺序，只保存仍在场上的敌人
+    QVector<QPair<qint16, qint64>> entries;
+    for (auto it = enemyEntryTimes.constBegin(); it != enemyEntryTimes.constEnd(); ++it)
+    {
+        int index = enemyIndex.value(it.key(), -1);
+        if (index >= 0)
+            entries.append(qMakePair(static_cast<qint16>(index), it.value()));
+    }
+    out << static_cast<quint16>(entries.size());
+    for (const QPair<qint16, qint64> &entry : entries)
+        out << entry.first << entry.second;
+}
+
+Tower *Tower::restoreState(QDataStream &in, const QList<QPointer<Enemy>> &enemies, QObject *parent)
+{
+    qint8 type = 0;
+    qreal posX = 0;
+    qreal posY = 0;
+    qint32 savedDamage = 0;
+    qint32 savedRange = 0;
+    qint32 savedFireRate = 0;
+    qint32 savedCost = 0;
+    qint64 savedSimTime = 0;
+    qint32 savedAccumulator = 0;
+    qreal savedItemRotation = 0;
+    qreal savedCurrentRotation = 0;
+    qreal savedTargetRotation = 0;
+    bool savedLocked = false;
+    qint64 savedLockedAt = -1;
+    qint64 savedLostTime = 0;
+    qint16 targetIndex = -1;
+    quint16 entryCount = 0;
+    in >> type >> posX >> posY >> savedDamage >> savedRange >> savedFireRate >> savedCost
+       >> savedSimTime >> savedAccumulator
+       >> savedItemRotation >> savedCurrentRotation >> savedTargetRotation
+       >> savedLocked >> savedLockedAt >> savedLostTime
+       >> targetIndex >> entryCount;
+    if (in.status() != QDataStream::Ok || type < ARROW_TOWER || type > MAGIC_TOWER || savedFireRate <= 0)
+        return nullptr;
+
+    Tower *tower = new Tower(static_cast<TowerType>(type), QPointF(posX, posY), parent);
+    tower->damage = savedDamage;
+    tower->range = savedRange;
+    tower->fireRate = savedFireRate;
+    tower->cost = savedCost;
+    tower->simTimeMs = savedSimTime;
+    tower->attackAccumulatorMs = savedAccumulator;
+    tower->setRotation(savedItemRotation);
+    tower->currentRotation = savedCurrentRotation;
+    tower->targetRotation = savedTargetRotation;
+    tower->targetLocked = savedLocked;
+    tower->targetLockedAtMs = savedLockedAt;
+    tower->targetLostTime = savedLostTime;
+
+    Enemy *target = enemies.value(targetIndex).data();
+    if (target)
+    {
+        tower->currentTarget = target;
+        target->setHighlighted(true);
+    }
+
+    for (quint16 i = 0; i < entryCount; ++i)
+    {
+        qint16 index = -1;
+        qint64 enteredAt = 0;
+        in >> index >> enteredAt;
+        Enemy *enemy = enemies.value(index).data();
+        if (enemy)
+            tower->enemyEntryTimes.insert(enemy, enteredAt);
+    }
+    return tower;
+}
+
 void Tower::setEnemiesInRange(const QList<QPointer<Enemy>> &enemies)
 {
-    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    qint64 now = simTimeMs;
 
     // 从追踪表中清除无效或超出范围的敌人
     auto it = enemyEntryTimes.begin();
@@ -213,7 +316,7 @@ void Tower::setEnemiesInRange(const QList<QPointer<Enemy>> &enemies)
     // 目标查找在 update() 中处理
 }
 
-void Tower::onAttackTimer()
+void Tower::onAttackTick()
 {
     // 检查当前目标是否仍在射程内
     if (currentTarget && isInRange(currentTarget))
@@ -245,7 +348,7 @@ void Tower::playSound(const QString &soundId, qreal volume, bool loop)
 
 void Tower::findTarget()
 {
-    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    qint64 now = simTimeMs;
 
     // 1. 检查当前目标是否仍然有效且在射程内
     if (currentTarget)
@@ -323,18 +426,14 @@ void Tower::updateTowerRotation()
         QPointF direction = targetCenter - towerCenter;
 
         // 计算目标方向角度
-        qreal angle = std::atan2(direction.y(), direction.x()) * 180.0 / M_PI;
+        qreal angle = FastMath::atan2Degrees(direction.y(), direction.x());
         angle += 90.0; // 根据图片方向调整
         targetRotation = angle;
     }
 
     // 旋转插值逻辑（平滑旋转）
-    qreal delta = targetRotation - currentRotation;
     // 处理角度环绕（确保旋转最短路径）
-    while (delta > 180.0)
-        delta -= 360.0;
-    while (delta < -180.0)
-        delta += 360.0;
+    qreal delta = FastMath::wrapDegrees(targetRotation - currentRotation);
 
     // 计算单帧旋转步长
     qreal stepPerFrame = rotationSpeed * (GameConfig::GAME_TICK_INTERVAL_MS / 1000.0);
@@ -377,8 +476,8 @@ void Tower::updateTargetLock()
             targetLocked = false;
             return;
         }
-        if (targetLockTimer.isValid() &&
-            targetLockTimer.hasExpired(GameConfig::TOWER_TARGET_LOCK_MS))
+        if (targetLockedAtMs >= 0 &&
+            simTimeMs - targetLockedAtMs >= GameConfig::TOWER_TARGET_LOCK_MS)
         {
             targetLocked = false;
             currentTarget = nullptr;
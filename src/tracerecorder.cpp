@@ -0,0 +1,97 @@
+#include "include/tracerecorder.h"
+
+#include <QFile>
+#include <QHash>
+#include <QThread>
+#include <QVector>
+
+TraceRecorder::TraceRecorder()
+    : recording(true)
+{
+    clock.start();
+}
+
+TraceRecorder &TraceRecorder::instance()
+{
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+void TraceRecorder::begin(const char *name, const char *category)
+{
+    record(name, category, 'B');
+}
+
+void TraceRecorder::end(const char *name, const char *category)
+{
+    record(name, category, 'E');
+}
+
+void TraceRecorder::instant(const char *name, const char *category)
+{
+    record(name, category, 'i');
+}
+
+void TraceRecorder::record(const char *name, const char *category, char phase)
+{
+    if (!isEnabled())
+        return;
+
+    Event event;
+    event.name = name;
+    event.category = category;
+    event.timestampNs = clock.nsecsElapsed();
+    event.threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+    event.phase = phase;
+    events.push(event);
+}
+
+QByteArray TraceRecorder::toChromeTraceJson() const
+{
+    QVector<Event> snapshot;
+    events.snapshot(snapshot);
+
+    // 将线程句柄映射为从 1 开始的紧凑编号
+    QHash<quintptr, int> threadIds;
+
+    QByteArray json;
+    json.reserve(snapshot.size() * 96 + 64);
+    json.append("{\"traceEvents\":[");
+
+    bool first = true;
+    for (const Event &event : snapshot)
+    {
+        int tid = threadIds.value(event.threadId, 0);
+        if (tid == 0)
+        {
+            tid = threadIds.size() + 1;
+            threadIds.insert(event.threadId, tid);
+        }
+
+        if (!first)
+            json.append(',');
+        first = false;
+
+        json.append("{\"name\":\"").append(event.name);
+        json.append("\",\"cat\":\"").append(event.category);
+        json.append("\",\"ph\":\"").append(event.phase);
+        json.append("\",\"ts\":").append(QByteArray::number(event.timestampNs / 1000.0, 'f', 3));
+        json.append(",\"pid\":1,\"tid\":").append(QByteArray::number(tid));
+        if (event.phase == 'i')
+            json.append(",\"s\":\"t\"");
+        json.append('}');
+    }
+
+    json.append("],\"displayTimeUnit\":\"ms\"}");
+    return json;
+}
+
+bool TraceRecorder::writeChromeTrace(const QString &filePath) const
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    QByteArray json = toChromeTraceJson();
+    return file.write(json) == json.size();
+}